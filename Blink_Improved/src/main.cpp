@@ -2,7 +2,7 @@
   Blink_Improved
 
   Turns an LED on and off for a defined period repeatedly without blocking
-  other code from running.
+  other code from running, and blinks a panel of further LEDs in step with it.
 
   Created Nov 2022
   by Beaker406
@@ -21,6 +21,21 @@
   model, check the Technical Specs of your board at:
   https://www.arduino.cc/en/Main/Products
 
+  The LEDs are driven by the ledPanel library found in the libraries folder of this sketchbook,
+  from a timer interrupt that counts every blink from one frame clock, so the LEDs stay in step
+  with each other for as long as the board runs and no period picks up loop() latency. Each LED
+  has its own period, phase and brightness, and loop() has nothing to do for them and just idles
+  the board until the next interrupt.
+
+  By default the on-board LED and fifteen more LEDs on pins 2 to 12 and A0 to A3 (each with a
+  series resistor to ground) make up the panel. Build with -D PANEL_SHIFT_REGISTERS=n (the
+  uno_shift_registers environment does) to drive 8n LEDs on a chain of 74HC595s instead, with
+  data on MOSI (11), clock on SCK (13) and the latch on pin 10; the on-board LED then flickers
+  with the clock and the first LED of the chain takes its place.
+
+  The other LEDs run a chase around the panel: each lights for an eighth of the chase period, a
+  step later than the one before it, alternating between full and quarter brightness.
+
   This example code is in the public domain.
 
   VS Code Extension Code Spell Checker ignore list
@@ -28,38 +43,51 @@
 */
 
 #include <Arduino.h> // comment this line out if using the Arduino IDE
+#include <ledPanel.h>
 
-// set the interval between LED state changes in milliseconds here
-const unsigned long runInterval = 1000UL;
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
 
-// set the pin number the LED is connected to, change if LED is user supplied
-const int ledPin = LED_BUILTIN;
+// set the interval between LED state changes in milliseconds here (up to 32767)
+const unsigned long runInterval = 1000UL;
 
-unsigned long lastMillis = millis(); // last LED toggle time
-unsigned long currentMillis; // current runtime set each loop iteration
+#ifdef PANEL_SHIFT_REGISTERS
+// set the pin latching the shift registers, the data and clock are the SPI pins
+const uint8_t latchPin = 10;
+const uint8_t panelLeds = PANEL_SHIFT_REGISTERS * 8;
+#else
+// set the pin numbers the LEDs are connected to, the first blinks every run interval
+const uint8_t panelPins[] = {LED_BUILTIN, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, A0, A1, A2, A3};
+const uint8_t panelLeds = sizeof(panelPins);
+#endif
 
-void digitalToggle(uint8_t pin); // digitalToggle function prototype
+// set the time a light takes to go once around the chase in milliseconds
+const uint16_t chasePeriod = 1600;
 
 void setup() {
-  pinMode(ledPin, OUTPUT); // set the digital pin as an output
-  digitalWrite(ledPin, HIGH); // turn the LED on initially
+#ifdef PANEL_SHIFT_REGISTERS
+  ledPanel::beginShiftRegisters(latchPin, PANEL_SHIFT_REGISTERS);
+#else
+  ledPanel::beginPins(panelPins, panelLeds); // make the pins outputs driven by the panel
+#endif
+
+  // on for one interval, then off for one interval, forever
+  ledPanel::blink(0, 2 * runInterval, 0, 255);
+
+  // the chase, each LED a step behind the one before it
+  uint8_t chaseLeds = panelLeds - 1;
+  uint16_t step = chasePeriod / chaseLeds;
+  for (uint8_t i = 0; i < chaseLeds; i++) {
+    uint16_t phase = chasePeriod - i * step;
+    ledPanel::blink(1 + i, chasePeriod, phase, i % 2 == 0 ? 255 : 64, chasePeriod / 8);
+  }
 }
 
 void loop() {
-  currentMillis = millis(); // record the current runtime of the loop
-
-  /*
-    if enough time has past such that:
-    current runtime minus the last toggle time is greater than the run interval
-    then toggle the LED and record the last toggle time
-  */
-  if (currentMillis - lastMillis >= runInterval) {
-    digitalToggle(ledPin);
-    lastMillis = millis();
-  }
+  // nothing to do, rest until the next interrupt
+#ifdef __AVR__
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+#endif
 }
-
-void digitalToggle(uint8_t pin) {
-  // read the current state of the pin and write the inverse
-  digitalWrite(pin, !digitalRead(pin));
-}
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*
+  buttonSize.cpp
+
+  The smallest sketch around one button, built twice to measure what fastButton saves on an AVR:
+  uno_size_button with the runtime button and uno_size_fast_button, built with -D SIZE_FAST_BUTTON,
+  with fastButton. Both debounce pin 9 (pull-down) for 50 ms, count presses and toggle the
+  on-board LED on each one, so the only difference between the RAM and flash sizes PlatformIO
+  prints after each build is the button class. Cycles per loop() are compared on the host by
+  fastButtonBench.cpp.
+
+  pio run -e uno_size_button -e uno_size_fast_button
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+
+#ifdef SIZE_FAST_BUTTON
+#include <fastButton.h>
+fastButton<9, INPUT, false, COUNT_PRESSES, 50> sizedButton;
+#else
+#include <button.h>
+button sizedButton(9, INPUT, false);
+#endif
+
+void setup() {
+#ifndef SIZE_FAST_BUTTON
+  sizedButton.setDebounceTime(50);
+#endif
+  pinMode(LED_BUILTIN, OUTPUT);
+}
+
+void loop() {
+  sizedButton.loop();
+  if (sizedButton.isPressed())
+    digitalWrite(LED_BUILTIN, sizedButton.getCount() & 1 ? HIGH : LOW);
+}
@@ -0,0 +1,290 @@
+/*
+  comboTimingBench.cpp
+
+  Timing side-channel benchmark for the combo check, run on the host with the native core
+  (pio run -e bench_combo_timing). A combo check leaks when the time it takes depends on how many
+  leading presses were right, because an attacker timing the lock's response can then find a combo
+  one press at a time instead of trying them all. The benchmark times every checker on blocks of
+  presses whose first k presses are right and the rest wrong, for every k from 0 to the combo length,
+  in cycles read from the CPU's time stamp counter around each check.
+
+  For each checker it prints the median cycles per block for a spread of k, and Welch's t-statistic
+  between the blocks with no right press and those with all but the last press right, after
+  dropping the slowest tenth of all samples as scheduling noise. Like dudect, a |t| above 4.5 is
+  taken as evidence of a leak. The classes are interleaved at random so drift in the host's clock
+  speed affects them all alike, and every block is made before any is timed.
+
+  The early-exit compare is the buffer comparison the lock used to have; it is there to show the
+  benchmark picks up a leak as small as one loop iteration per right press. The others should show
+  no leak: comboMatcher and comboSetMatcher in block mode, which the lock uses, and
+  packedSymbols::equals for a buffered history. Blocks with every press right are left out of the
+  t-test, as a match is meant to be seen.
+
+  Options:
+  --seed <n>           random seed (default 1)
+  --samples <n>        timed blocks per checker (default 200000)
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <comboMatcher.h>
+#include <comboSet.h>
+#include <packedSymbols.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+// fenced so the checked code can't be reordered around the reads
+static inline uint64_t cycleCount(void) {
+  _mm_lfence();
+  uint64_t cycles = __rdtsc();
+  _mm_lfence();
+  return cycles;
+}
+#else
+#include <chrono>
+static inline uint64_t cycleCount(void) {
+  return std::chrono::steady_clock::now().time_since_epoch().count();  // nanoseconds instead
+}
+#endif
+
+namespace {
+
+const uint8_t benchSymbols = 4;
+const uint8_t benchLength = 16;  // long enough that a per-press leak adds up to something visible
+const double leakThreshold = 4.5;
+
+constexpr uint8_t benchCombo[benchLength] = {3, 1, 2, 0, 2, 2, 1, 3, 0, 1, 3, 2, 0, 0, 1, 2};
+constexpr comboAutomaton<benchSymbols, benchLength> benchAutomaton =
+    buildComboAutomaton<benchSymbols>(benchCombo);
+
+// the bench combo among others of the same length, as several users of one lock would have
+constexpr uint8_t benchCombos[] = {
+    3, 1, 2, 0, 2, 2, 1, 3, 0, 1, 3, 2, 0, 0, 1, 2, comboAction(0),
+    3, 1, 2, 0, 1, 1, 0, 2, 3, 3, 0, 1, 2, 2, 0, 1, comboAction(1),
+    0, 0, 1, 1, 2, 2, 3, 3, 0, 0, 1, 1, 2, 2, 3, 3, comboAction(2),
+    2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, comboAction(3),
+};
+typedef comboSet<benchSymbols, comboSetNodes<benchSymbols>(benchCombos)> benchSet_t;
+constexpr benchSet_t benchSet = benchSet_t(benchCombos);
+
+struct benchOptions {
+  unsigned long seed = 1;
+  unsigned long samples = 200000;
+};
+
+// every checker gets a whole block of presses and tells whether it was the combo
+class checker {
+ public:
+  virtual ~checker() {}
+  virtual bool check(const uint8_t presses[]) = 0;
+};
+
+// the old compareArrays(): stops at the first difference
+class earlyExitCompare : public checker {
+ public:
+  bool check(const uint8_t presses[]) {
+    uint8_t i = 0;
+    bool same = true;
+    while (i < benchLength && same) {
+      same = presses[i] == comboCopy[i];
+      i++;
+    }
+    return same;
+  }
+
+ private:
+  uint8_t comboCopy[benchLength] = {3, 1, 2, 0, 2, 2, 1, 3, 0, 1, 3, 2, 0, 0, 1, 2};
+};
+
+class packedCompare : public checker {
+ public:
+  bool check(const uint8_t presses[]) {
+    history.clear();
+    for (uint8_t i = 0; i < benchLength; i++)
+      history.push(presses[i]);
+    return history.equals(benchCombo, benchLength);
+  }
+
+ private:
+  packedSymbols<benchSymbols, benchLength> history;
+};
+
+class automatonCheck : public checker {
+ public:
+  bool check(const uint8_t presses[]) {
+    comboResult result = COMBO_PENDING;
+    for (uint8_t i = 0; i < benchLength; i++)
+      result = matcher.press(presses[i]);
+    return result == COMBO_MATCHED;
+  }
+
+ private:
+  comboMatcher<benchSymbols, benchLength> matcher{benchAutomaton, COMBO_BLOCK};
+};
+
+class setCheck : public checker {
+ public:
+  bool check(const uint8_t presses[]) {
+    comboResult result = COMBO_PENDING;
+    for (uint8_t i = 0; i < benchLength && result == COMBO_PENDING; i++)
+      result = matcher.press(presses[i]);
+    return result == COMBO_MATCHED;
+  }
+
+ private:
+  comboSetMatcher<benchSet_t> matcher{benchSet, COMBO_BLOCK};
+};
+
+struct checkerType {
+  const char *name;
+  checker *(*create)(void);
+};
+
+template <class T>
+checker *createChecker(void) { return new T(); }
+
+const checkerType checkers[] = {
+    {"early-exit compare", createChecker<earlyExitCompare>},
+    {"packedSymbols", createChecker<packedCompare>},
+    {"comboMatcher", createChecker<automatonCheck>},
+    {"comboSetMatcher", createChecker<setCheck>},
+};
+
+// a block whose first right presses match the bench combo and whose next press doesn't
+void makeBlock(uint8_t block[], uint8_t right, std::mt19937 &rng) {
+  std::uniform_int_distribution<int> symbol(0, benchSymbols - 1);
+  std::uniform_int_distribution<int> other(1, benchSymbols - 1);
+  for (uint8_t i = 0; i < benchLength; i++) {
+    if (i < right)
+      block[i] = benchCombo[i];
+    else if (i == right)
+      block[i] = (benchCombo[i] + other(rng)) % benchSymbols;
+    else
+      block[i] = symbol(rng);
+  }
+}
+
+struct classStats {
+  double mean;
+  double variance;
+  size_t count;
+};
+
+classStats statsBelow(const std::vector<uint32_t> &samples, uint32_t limit) {
+  classStats s = {0, 0, 0};
+  for (size_t i = 0; i < samples.size(); i++) {
+    if (samples[i] > limit)
+      continue;
+    s.count++;
+    double delta = samples[i] - s.mean;
+    s.mean += delta / s.count;
+    s.variance += delta * (samples[i] - s.mean);
+  }
+  if (s.count > 1)
+    s.variance /= s.count - 1;
+  return s;
+}
+
+uint32_t median(std::vector<uint32_t> samples) {
+  if (samples.empty())
+    return 0;
+  std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+  return samples[samples.size() / 2];
+}
+
+bool parseOptions(int argc, char **argv, benchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--seed") == 0 && hasValue)
+      options.seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--samples") == 0 && hasValue)
+      options.samples = strtoul(argv[++i], NULL, 10);
+    else
+      return false;
+  }
+  return options.samples > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr, "usage: %s [--seed n] [--samples n]\n", argv[0]);
+    return 2;
+  }
+
+  const uint8_t shown[] = {0, 1, 4, 8, 12, benchLength - 1, benchLength};
+  printf("%u-press combo over %u symbols, %lu blocks per checker, seed %lu\n", benchLength,
+         benchSymbols, options.samples, options.seed);
+  printf("median cycles per block by right leading presses\n\n");
+  printf("%-20s", "checker");
+  for (size_t i = 0; i < sizeof(shown); i++)
+    printf(" %6u", shown[i]);
+  printf(" %9s  %s\n", "t", "verdict");
+
+  bool allPassed = true;
+  const size_t checkerCount = sizeof(checkers) / sizeof(checkers[0]);
+  for (size_t c = 0; c < checkerCount; c++) {
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> rightPresses(0, benchLength);
+    checker *subject = checkers[c].create();
+
+    // every block is made before any is timed, so making them can't disturb the timing
+    std::vector<uint8_t> rights(options.samples);
+    std::vector<uint8_t> blocks(options.samples * benchLength);
+    for (unsigned long s = 0; s < options.samples; s++) {
+      rights[s] = rightPresses(rng);
+      makeBlock(&blocks[s * benchLength], rights[s], rng);
+    }
+    std::vector<uint32_t> cycles(options.samples);
+    std::vector<uint8_t> matched(options.samples);
+    for (unsigned long s = 0; s < options.samples; s++) {
+      uint64_t start = cycleCount();
+      bool result = subject->check(&blocks[s * benchLength]);
+      cycles[s] = (uint32_t)(cycleCount() - start);
+      matched[s] = result;
+    }
+    delete subject;
+
+    std::vector<uint32_t> byRight[benchLength + 1];
+    bool wrongResult = false;
+    for (unsigned long s = 0; s < options.samples; s++) {
+      byRight[rights[s]].push_back(cycles[s]);
+      wrongResult |= (matched[s] != 0) != (rights[s] == benchLength);
+    }
+
+    std::vector<uint32_t> sorted = cycles;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() * 9 / 10, sorted.end());
+    uint32_t limit = sorted[sorted.size() * 9 / 10];
+    classStats none = statsBelow(byRight[0], limit);
+    classStats most = statsBelow(byRight[benchLength - 1], limit);
+    double t = (most.mean - none.mean) /
+               sqrt(none.variance / (none.count ? none.count : 1) +
+                    most.variance / (most.count ? most.count : 1) + 1e-12);
+    bool leaks = fabs(t) > leakThreshold;
+
+    printf("%-20s", checkers[c].name);
+    for (size_t i = 0; i < sizeof(shown); i++)
+      printf(" %6u", median(byRight[shown[i]]));
+    printf(" %9.2f  %s%s\n", t, leaks ? "leaks" : "no leak detected",
+           wrongResult ? ", WRONG RESULTS" : "");
+    // the early-exit compare is expected to leak, it shows the benchmark can tell
+    if (c > 0 && (leaks || wrongResult))
+      allPassed = false;
+  }
+  return allPassed ? 0 : 1;
+}
@@ -0,0 +1,400 @@
+/*
+  debounceBench.cpp
+
+  Debounce latency and accuracy benchmark for the button library, run on the host with the native
+  core (pio run -e bench_debounce). Every debounce engine is fed the same contact bounce traces at
+  microsecond resolution for a sweep of debounce times, and for each combination it reports:
+
+  - press-to-detection latency percentiles, from the first contact of a press to isPressed()
+  - missed presses, real presses that were never reported
+  - phantom presses, reports that don't belong to a real press or repeat one
+  - host CPU time and cycles per loop() call, the median of every call timed on its own less the
+    median for an empty call through the same interface, and never below zero
+
+  Traces are generated from a seeded model of a pushbutton: presses with randomized hold times,
+  bursts of contact bounce on press and release, occasional long bouncers, and short noise spikes
+  while the button is idle. A recorded trace can be benchmarked instead with --script, using the
+  native core's "<time in ms> <pin> <level>" script format on pin 9 together with --presses to give
+  the true number of presses in it. Only counts can be checked for recorded traces.
+
+  Options:
+  --seed <n>           random seed for generated traces (default 1)
+  --presses <n>        presses to generate, or the true count of a recorded trace (default 1000)
+  --loop-us <us>       virtual time between loop() calls (default 100)
+  --script <file>      benchmark a recorded trace instead of generated ones
+
+  The smallest debounce time with no missed or phantom presses is listed for each engine at the end.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <button.h>
+#include <buttonGroup.h>
+#include <verticalCounter.h>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycleCount(void) { return __rdtsc(); }
+#else
+static inline uint64_t cycleCount(void) { return 0; }
+#endif
+
+namespace {
+
+const uint8_t benchPin = 9;  // wired like the combo buttons, pull-down so pressed reads HIGH
+const unsigned long debounceTimes[] = {1, 2, 5, 10, 20, 30, 50};
+
+struct benchOptions {
+  unsigned long seed = 1;
+  unsigned long presses = 1000;
+  unsigned long loopMicros = 100;
+  const char *script = NULL;
+};
+
+struct levelChange {
+  uint64_t time;
+  uint8_t level;
+};
+
+struct trace {
+  std::vector<levelChange> changes;
+  std::vector<uint64_t> pressStarts;  // first contact of every real press, empty if unknown
+  unsigned long pressCount;
+  uint64_t length;
+};
+
+// a burst of contact bounce settling on a level, returns when the contacts settled
+uint64_t addBounce(trace &t, std::mt19937 &rng, uint64_t start, uint8_t settleLevel) {
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  // most contacts settle within a few ms, some worn ones take a lot longer
+  double limit = chance(rng) < 0.05 ? 15000.0 : 5000.0;
+  uint64_t duration = (uint64_t)(chance(rng) * limit);
+  std::uniform_int_distribution<int> gap(10, 500);
+
+  uint64_t time = start;
+  uint8_t level = settleLevel;
+  while (time < start + duration) {
+    t.changes.push_back({time, level});
+    level = !level;
+    time += gap(rng);
+  }
+  t.changes.push_back({time, settleLevel});
+  return time;
+}
+
+trace generateTrace(const benchOptions &options) {
+  std::mt19937 rng(options.seed);
+  std::uniform_int_distribution<int> idle(150000, 600000);  // between presses
+  std::uniform_int_distribution<int> hold(30000, 300000);   // from settling to release
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  std::uniform_int_distribution<int> spike(20, 200);
+
+  trace t;
+  t.pressCount = options.presses;
+  uint64_t time = 100000;
+  for (unsigned long i = 0; i < options.presses; i++) {
+    // a noise spike now and then while nobody touches the button
+    if (chance(rng) < 0.2) {
+      uint64_t at = time + idle(rng) / 2;
+      t.changes.push_back({at, HIGH});
+      t.changes.push_back({at + spike(rng), LOW});
+    }
+    time += idle(rng);
+
+    t.pressStarts.push_back(time);
+    time = addBounce(t, rng, time, HIGH) + hold(rng);
+    time = addBounce(t, rng, time, LOW);
+  }
+  t.length = time + 500000;
+  return t;
+}
+
+// the common interface the benchmark drives every engine through
+class engine {
+ public:
+  virtual ~engine() {}
+  virtual void setDebounceTime(unsigned long time) = 0;
+  virtual void loop(void) = 0;
+  virtual bool isPressed(void) = 0;
+};
+
+class pollingButton : public engine {
+  button b{benchPin, INPUT, false};
+
+ public:
+  void setDebounceTime(unsigned long time) { b.setDebounceTime(time); }
+  void loop(void) { b.loop(); }
+  bool isPressed(void) { return b.isPressed(); }
+};
+
+class interruptButton : public engine {
+  button b{benchPin, INPUT, false};
+
+ public:
+  interruptButton() { b.enableInterrupts(); }
+  ~interruptButton() { b.disableInterrupts(); }
+  void setDebounceTime(unsigned long time) { b.setDebounceTime(time); }
+  void loop(void) { b.loop(); }
+  bool isPressed(void) { return b.isPressed(); }
+};
+
+const uint8_t benchPins[] = {benchPin};
+
+template <class group>
+class groupButton : public engine {
+  group g{benchPins, INPUT, false};
+
+ public:
+  void setDebounceTime(unsigned long time) { g.setDebounceTime(time); }
+  void loop(void) { g.loop(); }
+  bool isPressed(void) { return g.isPressed(0); }
+};
+
+struct engineType {
+  const char *name;
+  engine *(*create)(void);
+};
+
+template <class T>
+engine *createEngine(void) { return new T(); }
+
+const engineType engines[] = {
+    {"button", createEngine<pollingButton>},
+    {"button+irq", createEngine<interruptButton>},
+    {"buttonGroup", createEngine<groupButton<buttonGroup<1> > >},
+    {"verticalGroup", createEngine<groupButton<verticalButtonGroup<1> > >},
+};
+
+// the median of per-call samples, counted in a histogram since a trace makes millions of them
+class sampleMedian {
+ public:
+  static const size_t buckets = 4096;  // longer samples count as the longest bucket
+
+  sampleMedian() : counts(buckets, 0), total(0) {}
+
+  void add(uint64_t sample) {
+    counts[sample < buckets ? sample : buckets - 1]++;
+    total++;
+  }
+
+  double median(void) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets; i++) {
+      seen += counts[i];
+      if (2 * seen >= total)
+        return i;
+    }
+    return 0;
+  }
+
+ private:
+  std::vector<uint64_t> counts;
+  uint64_t total;
+};
+
+// the cost of the timing code itself, measured around a call of an engine that does nothing
+struct timingOverhead {
+  double nanos;
+  double cycles;
+};
+
+class emptyEngine : public engine {
+ public:
+  void setDebounceTime(unsigned long) {}
+  void loop(void) {}
+  bool isPressed(void) { return false; }
+};
+
+// one timed call, adding its host time and cycles to the samples
+inline void timeLoop(engine *e, sampleMedian &nanos, sampleMedian &cycles) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  uint64_t startCycles = cycleCount();
+  e->loop();
+  uint64_t elapsedCycles = cycleCount() - startCycles;
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  nanos.add(elapsed.count());
+  cycles.add(elapsedCycles);
+}
+
+timingOverhead measureOverhead(void) {
+  const int calls = 100000;
+  engine *volatile e = new emptyEngine();
+  sampleMedian nanos;
+  sampleMedian cycles;
+  for (int i = 0; i < calls; i++)
+    timeLoop(e, nanos, cycles);
+  delete e;
+  timingOverhead overhead = {nanos.median(), cycles.median()};
+  return overhead;
+}
+
+struct result {
+  std::vector<double> latencies;  // ms
+  unsigned long detected;
+  unsigned long missed;
+  unsigned long phantom;
+  double nanosPerLoop;
+  double cyclesPerLoop;
+};
+
+result runTrace(const engineType &type, unsigned long debounceTime, const trace &t,
+                const benchOptions &options, const timingOverhead &overhead) {
+  nativeHal::reset();
+  for (size_t i = 0; i < t.changes.size(); i++)
+    nativeHal::schedulePin(benchPin, t.changes[i].time, t.changes[i].level);
+  if (options.script != NULL)
+    nativeHal::loadScript(options.script);
+
+  engine *e = type.create();
+  e->setDebounceTime(debounceTime);
+
+  std::vector<uint64_t> detections;
+  sampleMedian nanos;
+  sampleMedian cycles;
+  while (nativeHal::now() < t.length) {
+    timeLoop(e, nanos, cycles);
+
+    if (e->isPressed())
+      detections.push_back(nativeHal::now());
+    nativeHal::advance(options.loopMicros);
+  }
+  delete e;
+
+  result r;
+  r.detected = detections.size();
+  r.missed = 0;
+  r.phantom = 0;
+  r.nanosPerLoop = std::max(nanos.median() - overhead.nanos, 0.0);
+  r.cyclesPerLoop = std::max(cycles.median() - overhead.cycles, 0.0);
+
+  if (t.pressStarts.empty()) {
+    // a recorded trace only tells us how many presses there should be
+    if (r.detected < t.pressCount)
+      r.missed = t.pressCount - r.detected;
+    else
+      r.phantom = r.detected - t.pressCount;
+    return r;
+  }
+
+  // each detection belongs to the latest press that started before it, the first one per press
+  // is the real detection and anything else is a phantom
+  size_t d = 0;
+  while (d < detections.size() && detections[d] < t.pressStarts[0]) {
+    r.phantom++;
+    d++;
+  }
+  for (size_t p = 0; p < t.pressStarts.size(); p++) {
+    uint64_t end = p + 1 < t.pressStarts.size() ? t.pressStarts[p + 1] : t.length;
+    unsigned long inWindow = 0;
+    while (d < detections.size() && detections[d] < end) {
+      if (inWindow == 0)
+        r.latencies.push_back((detections[d] - t.pressStarts[p]) / 1000.0);
+      inWindow++;
+      d++;
+    }
+    if (inWindow == 0)
+      r.missed++;
+    else
+      r.phantom += inWindow - 1;
+  }
+  return r;
+}
+
+double percentile(std::vector<double> &sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+bool parseOptions(int argc, char **argv, benchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--seed") == 0 && hasValue)
+      options.seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--presses") == 0 && hasValue)
+      options.presses = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--loop-us") == 0 && hasValue)
+      options.loopMicros = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--script") == 0 && hasValue)
+      options.script = argv[++i];
+    else
+      return false;
+  }
+  return options.loopMicros > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr,
+            "usage: %s [--seed n] [--presses n] [--loop-us us] [--script file]\n", argv[0]);
+    return 2;
+  }
+
+  trace t;
+  if (options.script != NULL) {
+    // find where the recorded trace ends so the run covers all of it
+    nativeHal::reset();
+    if (!nativeHal::loadScript(options.script))
+      return 1;
+    t.pressCount = options.presses;
+    t.length = 0;
+    FILE *file = fopen(options.script, "r");
+    char line[128];
+    double ms;
+    while (fgets(line, sizeof(line), file) != NULL) {
+      if (sscanf(line, " %lf", &ms) == 1 && ms * 1000.0 > t.length)
+        t.length = (uint64_t)(ms * 1000.0);
+    }
+    fclose(file);
+    t.length += 500000;
+    printf("recorded trace %s, %lu presses, loop every %lu us\n\n", options.script, t.pressCount,
+           options.loopMicros);
+  } else {
+    t = generateTrace(options);
+    printf("generated trace, seed %lu, %lu presses, %zu level changes, loop every %lu us\n\n",
+           options.seed, t.pressCount, t.changes.size(), options.loopMicros);
+  }
+
+  timingOverhead overhead = measureOverhead();
+  printf("%-14s %9s %8s %8s %8s %8s %7s %8s %9s %9s\n", "engine", "debounce", "p50 ms",
+         "p90 ms", "p99 ms", "max ms", "missed", "phantom", "ns/loop", "cyc/loop");
+
+  const size_t engineCount = sizeof(engines) / sizeof(engines[0]);
+  const size_t debounceCount = sizeof(debounceTimes) / sizeof(debounceTimes[0]);
+  for (size_t e = 0; e < engineCount; e++) {
+    long best = -1;
+    for (size_t d = 0; d < debounceCount; d++) {
+      result r = runTrace(engines[e], debounceTimes[d], t, options, overhead);
+      std::sort(r.latencies.begin(), r.latencies.end());
+      printf("%-14s %6lu ms %8.2f %8.2f %8.2f %8.2f %7lu %8lu %9.1f %9.1f\n", engines[e].name,
+             debounceTimes[d], percentile(r.latencies, 50), percentile(r.latencies, 90),
+             percentile(r.latencies, 99), r.latencies.empty() ? 0.0 : r.latencies.back(),
+             r.missed, r.phantom, r.nanosPerLoop, r.cyclesPerLoop);
+      if (best < 0 && r.missed == 0 && r.phantom == 0)
+        best = debounceTimes[d];
+    }
+    if (best < 0)
+      printf("%-14s no debounce time without false counts\n\n", engines[e].name);
+    else
+      printf("%-14s smallest debounce time without false counts: %ld ms\n\n", engines[e].name,
+             best);
+  }
+  return 0;
+}
@@ -0,0 +1,227 @@
+/*
+  fastButtonBench.cpp
+
+  Side-by-side benchmark of button and fastButton, run on the host with the native core (pio run
+  -e bench_fast_button). Both are configured the same way, on pin 9 with a pull-down, counting
+  presses with a 50 ms debounce time: button at runtime and fastButton through its template
+  parameters. Both read the same contact bounce trace on that pin, and on every loop() pass the
+  program checks that they agree. For each it reports:
+
+  - disagreements, passes where isPressed(), isReleased() or getCount() differ between the two
+  - presses counted over the whole trace
+  - RAM taken by one object, sizeof on this host (see below for the AVR)
+  - host CPU time and cycles per loop() call, the median of every call timed on its own less the
+    median for an empty call made the same way, and never below zero
+
+  The host numbers only compare the two against each other. Flash, and the RAM an Uno really
+  spends, come from the AVR build: the uno_size_button and uno_size_fast_button environments build
+  src/bench/buttonSize.cpp around one button of either kind, and the difference between the sizes
+  PlatformIO prints for them is what fastButton saves.
+
+  The trace is generated from a seeded model of a pushbutton like the one in debounceBench.cpp:
+  presses with randomized hold times, bursts of contact bounce on press and release, and short
+  noise spikes while the button is idle.
+
+  Options:
+  --seed <n>           random seed (default 1)
+  --presses <n>        presses to generate (default 1000)
+  --loop-us <us>       virtual time between loop() calls (default 100)
+
+  The program exits non-zero if the two ever disagree.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <button.h>
+#include <fastButton.h>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycleCount(void) { return __rdtsc(); }
+#else
+static inline uint64_t cycleCount(void) { return 0; }
+#endif
+
+namespace {
+
+const uint8_t benchPin = 9;  // wired like the combo buttons, pull-down so pressed reads HIGH
+const unsigned long benchDebounceTime = 50;
+
+typedef fastButton<benchPin, INPUT, false, COUNT_PRESSES, benchDebounceTime> benchFastButton;
+
+struct benchOptions {
+  unsigned long seed = 1;
+  unsigned long presses = 1000;
+  unsigned long loopMicros = 100;
+};
+
+// schedules a burst of contact bounce settling on a level, returns when the contacts settled
+uint64_t addBounce(std::mt19937 &rng, uint64_t start, uint8_t settleLevel) {
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  uint64_t duration = (uint64_t)(chance(rng) * 5000.0);
+  std::uniform_int_distribution<int> gap(10, 500);
+
+  uint64_t time = start;
+  uint8_t level = settleLevel;
+  while (time < start + duration) {
+    nativeHal::schedulePin(benchPin, time, level);
+    level = !level;
+    time += gap(rng);
+  }
+  nativeHal::schedulePin(benchPin, time, settleLevel);
+  return time;
+}
+
+// schedules the trace on the bench pin, returns its length in microseconds
+uint64_t scheduleTrace(const benchOptions &options) {
+  std::mt19937 rng(options.seed);
+  std::uniform_int_distribution<int> idle(150000, 600000);  // between presses
+  std::uniform_int_distribution<int> hold(30000, 300000);   // from settling to release
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  std::uniform_int_distribution<int> spike(20, 200);
+
+  uint64_t time = 100000;
+  for (unsigned long i = 0; i < options.presses; i++) {
+    // a noise spike now and then while nobody touches the button
+    if (chance(rng) < 0.2) {
+      uint64_t at = time + idle(rng) / 2;
+      nativeHal::schedulePin(benchPin, at, HIGH);
+      nativeHal::schedulePin(benchPin, at + spike(rng), LOW);
+    }
+    time += idle(rng);
+    time = addBounce(rng, time, HIGH) + hold(rng);
+    time = addBounce(rng, time, LOW);
+  }
+  return time + 500000;
+}
+
+// the median of per-call samples, counted in a histogram since a trace makes millions of them
+class sampleMedian {
+ public:
+  static const size_t buckets = 4096;  // longer samples count as the longest bucket
+
+  sampleMedian() : counts(buckets, 0), total(0) {}
+
+  void add(uint64_t sample) {
+    counts[sample < buckets ? sample : buckets - 1]++;
+    total++;
+  }
+
+  double median(void) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets; i++) {
+      seen += counts[i];
+      if (2 * seen >= total)
+        return i;
+    }
+    return 0;
+  }
+
+ private:
+  std::vector<uint64_t> counts;
+  uint64_t total;
+};
+
+struct loopTimes {
+  sampleMedian nanos;
+  sampleMedian cycles;
+};
+
+// each call is made through a function pointer the compiler can't see through, so neither button
+// gets inlined into the timing code and the empty call costs what the timing itself does
+button *runtimeButton;
+benchFastButton *templateButton;
+
+void loopRuntime(void) { runtimeButton->loop(); }
+void loopTemplate(void) { templateButton->loop(); }
+void loopNothing(void) {}
+
+void timeLoop(void (*volatile call)(void), loopTimes &times) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  uint64_t startCycles = cycleCount();
+  call();
+  uint64_t elapsedCycles = cycleCount() - startCycles;
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  times.nanos.add(elapsed.count());
+  times.cycles.add(elapsedCycles);
+}
+
+bool parseOptions(int argc, char **argv, benchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--seed") == 0 && hasValue)
+      options.seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--presses") == 0 && hasValue)
+      options.presses = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--loop-us") == 0 && hasValue)
+      options.loopMicros = strtoul(argv[++i], NULL, 10);
+    else
+      return false;
+  }
+  return options.loopMicros > 0;
+}
+
+void printRow(const char *name, size_t ram, unsigned long presses, const loopTimes &times,
+              const loopTimes &overhead) {
+  printf("%-12s %8zu %8lu %9.1f %9.1f\n", name, ram, presses,
+         std::max(times.nanos.median() - overhead.nanos.median(), 0.0),
+         std::max(times.cycles.median() - overhead.cycles.median(), 0.0));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr, "usage: %s [--seed n] [--presses n] [--loop-us us]\n", argv[0]);
+    return 2;
+  }
+
+  nativeHal::reset();
+  uint64_t length = scheduleTrace(options);
+  printf("generated trace, seed %lu, %lu presses, debounce %lu ms, loop every %lu us\n\n",
+         options.seed, options.presses, benchDebounceTime, options.loopMicros);
+
+  button runtime(benchPin, INPUT, false);
+  runtime.setDebounceTime(benchDebounceTime);
+  benchFastButton fast;
+  runtimeButton = &runtime;
+  templateButton = &fast;
+
+  loopTimes runtimeTimes;
+  loopTimes templateTimes;
+  loopTimes overhead;
+  unsigned long disagreements = 0;
+  while (nativeHal::now() < length) {
+    timeLoop(loopRuntime, runtimeTimes);
+    timeLoop(loopTemplate, templateTimes);
+    timeLoop(loopNothing, overhead);
+
+    if (runtime.isPressed() != fast.isPressed() || runtime.isReleased() != fast.isReleased() ||
+        runtime.getCount() != fast.getCount()) {
+      if (disagreements == 0)
+        printf("first disagreement at %.3f ms\n\n", nativeHal::now() / 1000.0);
+      disagreements++;
+    }
+    nativeHal::advance(options.loopMicros);
+  }
+
+  printf("%-12s %8s %8s %9s %9s\n", "engine", "RAM B", "presses", "ns/loop", "cyc/loop");
+  printRow("button", sizeof(runtime), runtime.getCount(), runtimeTimes, overhead);
+  printRow("fastButton", sizeof(fast), fast.getCount(), templateTimes, overhead);
+  printf("\n%lu disagreements\n", disagreements);
+  return disagreements == 0 ? 0 : 1;
+}
@@ -0,0 +1,824 @@
+/*
+  fleetSimulator.cpp
+
+  Soak test for the lock, run on the host with the native core (pio run -e bench_fleet). Thousands
+  of independent locks, each a combinationLock fed by a buttonGroup debouncer exactly as a sketch
+  would feed it, are run against press traces on their own virtual clocks, so hours of use take
+  milliseconds. Every lock is checked on every pass against a model of how the lock should behave,
+  written from the sketch's description rather than from the lock's code:
+
+  - the debouncer reports an edge once, and only once, a key's level has been steady for the
+    debounce time
+  - the states follow the presses, the combo input timeout and the lockout
+  - an accessory is only on after a correct combo, and with the green LED until primed again
+  - the blue LED is on exactly while unprimed, and the red LED flashes on and off for the flash
+    interval after an incorrect combo and is lit through a lockout
+  - the lock is never primed past its combo input timeout
+
+  A lock that breaks one of them is reported with the simulated time it happened at, and is not
+  checked any further. The program exits non-zero if any did.
+
+  Each lock gets its own settings, drawn at random across their valid range: combo input timeout,
+  debounce time, lockout and red flash. Its clock starts at a random point, many of them shortly
+  before millis() wraps around. Traces are generated from a seeded model of people using the lock:
+  priming, correct and wrong combos, slow presses that outlast the timeout, contact bounce on every
+  press and release, and noise spikes shorter than a press. With --script every lock plays the
+  same recorded trace instead, in the native core's "<time in ms> <pin> <level>" format with the
+  sketch's pins, 8 to prime and 9 to 11 for the combo.
+
+  Passes are taken every millisecond while anything is happening, as the sketch's loop does between
+  timer ticks, and idle time in between is skipped. The locks are run in slices of simulated time
+  on a work-stealing thread pool: each thread starts with a shard of the locks and runs them a
+  slice at a time, and a thread that runs out takes slices from the other end of another's queue.
+
+  At the end it reports the simulated hours, passes per second of host time, every transition
+  between states and how often it was seen, the transitions the lock can make that weren't seen,
+  and the invariant violations.
+
+  Options:
+  --locks <n>          locks to simulate (default 2000)
+  --hours <n>          simulated hours per lock (default 24)
+  --threads <n>        worker threads (default one per hardware thread)
+  --seed <n>           random seed (default 1)
+  --correct <percent>  combos entered correctly (default 60)
+  --script <file>      play a recorded trace on every lock instead of generated ones
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <buttonGroup.h>
+#include <combinationLock.h>
+#include <comboSet.h>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock hostClock;
+
+// the sketch's keys: the priming button, then the combo buttons
+const uint8_t keyPins[] = {8, 9, 10, 11};
+const uint8_t keyCount = sizeof(keyPins);
+const uint8_t comboButtons = keyCount - 1;
+
+// the sketch's combo, so recorded traces open the lock as they would the board, and a second one
+// with its own accessory
+const uint8_t firstCombo[] = {0, 1, 2};
+const uint8_t secondCombo[] = {2, 1, 0};
+const uint8_t comboLength = sizeof(firstCombo);
+constexpr uint8_t simCombos[] = {
+    0, 1, 2, comboAction(0),
+    2, 1, 0, comboAction(1),
+};
+const uint8_t simAccessories = 2;
+typedef comboSet<comboButtons, comboSetNodes<comboButtons>(simCombos)> simComboSet;
+constexpr simComboSet simComboTable = simComboSet(simCombos);
+
+const unsigned long msPerHour = 3600000UL;
+const uint64_t sliceTime = 15 * 60000UL;  // simulated time a lock runs for before it is requeued
+
+struct simOptions {
+  unsigned long locks = 2000;
+  double hours = 24;
+  unsigned threads = 0;
+  unsigned long seed = 1;
+  unsigned correctPercent = 60;
+  const char *script = NULL;
+};
+
+// the attempt log kept in RAM, the EEPROM is shared by the whole host process
+class memoryLog {
+ public:
+  memoryLog() : failureCount(0), lockout(false) {}
+  void recordFailure(void) {
+    if (failureCount < 0xFF)
+      failureCount++;
+  }
+  void recordSuccess(void) { failureCount = 0; }
+  void recordLockout(bool started) { lockout = started; }
+  void flush(void) {}
+  uint8_t failures(void) const { return failureCount; }
+  bool lockedOut(void) const { return lockout; }
+
+ private:
+  uint8_t failureCount;
+  bool lockout;
+};
+
+// the levels of simulated pins instead of a port
+template <uint8_t N>
+class simSampler {
+ public:
+  typedef typename buttonMask<N>::type mask_t;
+  void begin(const uint8_t *, uint8_t) { levels = 0; }
+  mask_t read(void) const { return levels; }
+  mask_t levels;
+};
+
+class simKeys : public buttonGroup<keyCount, unsigned long, simSampler<keyCount> > {
+ public:
+  simKeys() : buttonGroup(keyPins, INPUT, false) {}
+  void setLevels(mask_t levels) { sampler.levels = levels; }
+};
+
+typedef combinationLock<simComboSet, comboButtons, simAccessories, false, memoryLog> simLock;
+
+enum violationKind { EARLY_EDGE,
+                     MISSED_EDGE,
+                     ACCESSORY_WITHOUT_COMBO,
+                     PRIMED_PAST_TIMEOUT,
+                     WRONG_STATE,
+                     WRONG_OUTPUTS,
+                     VIOLATION_KINDS };
+
+const char *const violationNames[VIOLATION_KINDS] = {
+    "edge before the debounce time", "edge missed after the debounce time",
+    "accessory on without a correct combo", "primed past the combo input timeout",
+    "state differs from the model", "LEDs differ from the model"};
+
+const char *const stateNames[LOCK_STATE_COUNT] = {"not primed", "primed", "correct combo",
+                                                   "incorrect combo", "locked out"};
+
+// the transitions between passes the lock is expected to make
+const bool expectedTransitions[LOCK_STATE_COUNT][LOCK_STATE_COUNT] = {
+    // to: not primed, primed, correct, incorrect, locked out
+    {false, true, false, false, true},   // from not primed (locked out when resumed)
+    {true, false, true, true, false},    // from primed
+    {false, true, false, false, false},  // from correct combo
+    {true, true, false, false, true},    // from incorrect combo
+    {true, false, false, false, false},  // from locked out
+};
+
+struct rawEdge {
+  uint64_t time;  // simulated ms from the lock's start
+  uint8_t key;
+  uint8_t level;
+};
+
+// how the lock should behave, from the sketch's description
+struct lockModel {
+  uint8_t state = LOCK_NOT_PRIMED;
+  bool timing = false;
+  unsigned long timeOutAt = 0;
+  unsigned long lockoutEndsAt = 0;
+  uint8_t failures = 0;
+  bool flashing = false;
+  unsigned long flashStart = 0;
+  uint8_t open = comboNoAction;  // accessory switched on
+  uint8_t entered[comboLength];
+  uint8_t presses = 0;
+};
+
+struct simInstance {
+  lockSettings settings;
+  memoryLog history;
+  lockScheduler timers;
+  simKeys keys;
+  simLock locks[1];
+
+  std::mt19937_64 random;
+  unsigned long startClock;
+  uint64_t time = 0;  // simulated ms run so far
+  uint64_t endTime;
+  std::vector<rawEdge> edges;  // upcoming, in time order
+  size_t nextEdge = 0;
+  uint8_t raw = 0;        // levels of the keys, pressed bits set
+  uint64_t rawSince[keyCount] = {};
+  uint8_t flashCount;
+  uint16_t flashInterval;
+
+  lockModel model;
+  unsigned long primedAt = 0;
+  bool diverged = false;
+  uint8_t lastState = LOCK_NOT_PRIMED;
+
+  simInstance(const lockSettings &s, uint8_t flashCount, uint16_t flashInterval)
+      : settings(s),
+        locks{simLock(simComboTable, COMBO_BLOCK, settings, history, timers, flashCount,
+                      flashInterval)},
+        flashCount(flashCount),
+        flashInterval(flashInterval) {}
+};
+
+struct violation {
+  unsigned long lock;
+  uint64_t time;
+  uint8_t kind;
+  std::string detail;
+};
+
+// totals of a worker, added up at the end
+struct simTotals {
+  uint64_t passes = 0;
+  uint64_t edges = 0;
+  uint64_t simulatedMs = 0;
+  uint64_t slices = 0;
+  uint64_t stolen = 0;
+  uint64_t resets = 0;
+  uint64_t transitions[LOCK_STATE_COUNT][LOCK_STATE_COUNT] = {};
+  uint64_t violations[VIOLATION_KINDS] = {};
+};
+
+std::mutex reportLock;
+std::vector<violation> firstViolations;
+const size_t violationsShown = 10;
+
+std::vector<rawEdge> scriptEdges;
+unsigned correctPercent;
+
+uint64_t uniform(std::mt19937_64 &random, uint64_t low, uint64_t high) {
+  return std::uniform_int_distribution<uint64_t>(low, high)(random);
+}
+
+bool chance(std::mt19937_64 &random, unsigned percent) { return uniform(random, 0, 99) < percent; }
+
+// a press of a key from time on, with contact bounce on both edges; returns when it is released
+uint64_t addPress(simInstance &lock, uint8_t key, uint64_t time, uint64_t hold) {
+  std::mt19937_64 &random = lock.random;
+  for (uint8_t level = 1;; level = 0) {
+    lock.edges.push_back({time, key, level});
+    // bounce: the contact opens and closes again a few times, a ms or more apart
+    unsigned bounces = chance(random, 50) ? (unsigned)uniform(random, 1, 3) : 0;
+    for (unsigned i = 0; i < bounces; i++) {
+      time += uniform(random, 1, 15);
+      lock.edges.push_back({time, key, (uint8_t)!level});
+      time += uniform(random, 1, 15);
+      lock.edges.push_back({time, key, level});
+    }
+    if (level == 0)
+      return time;
+    time += hold;
+  }
+}
+
+uint64_t pressGap(simInstance &lock) {
+  // now and then slower than any timeout
+  if (chance(lock.random, 3))
+    return uniform(lock.random, 1000, 40000);
+  return uniform(lock.random, 30, 1500);
+}
+
+// a press without bounce that the debouncer reports at exactly reportedAt
+void addCleanPress(simInstance &lock, uint8_t key, uint64_t reportedAt) {
+  uint64_t down = reportedAt - lock.settings.comboDebounceTime;
+  lock.edges.push_back({down, key, 1});
+  lock.edges.push_back({down + 40, key, 0});
+}
+
+// a wrong combo whose last press lands within a millisecond or two of the input timeout, sometimes
+// followed by priming a millisecond or two after it
+void addBoundaryEpisode(simInstance &lock, uint64_t time) {
+  std::mt19937_64 &random = lock.random;
+  uint64_t primed = time + lock.settings.comboDebounceTime;
+  addCleanPress(lock, 0, primed);
+  uint64_t rejected = primed + lock.settings.comboInputTimeOut - uniform(random, 0, 2);
+  for (uint8_t i = 0; i < comboLength; i++)
+    addCleanPress(lock, 1, rejected - 120 * (comboLength - 1 - i));
+  if (chance(random, 50))
+    addCleanPress(lock, 0, rejected + uniform(random, 0, 2));
+}
+
+// someone walks up, primes and tries a few combos
+void addEpisode(simInstance &lock) {
+  std::mt19937_64 &random = lock.random;
+  lock.edges.clear();
+  lock.nextEdge = 0;
+
+  uint64_t gap;
+  uint8_t kind = uniform(random, 0, 99);
+  if (kind < 70)
+    gap = uniform(random, 500, 60000);
+  else if (kind < 95)
+    gap = uniform(random, 60000, 1800000);
+  else
+    gap = uniform(random, 1800000, 5 * msPerHour);
+  uint64_t time = lock.time + gap;
+  if (chance(random, 5)) {
+    addBoundaryEpisode(lock, time);
+    std::stable_sort(lock.edges.begin(), lock.edges.end(),
+                     [](const rawEdge &a, const rawEdge &b) { return a.time < b.time; });
+    return;
+  }
+
+  time = addPress(lock, 0, time, uniform(random, 20, 400)) + pressGap(lock);
+  unsigned combos = uniform(random, 1, 3);
+  for (unsigned c = 0; c < combos; c++) {
+    uint8_t symbols[8];
+    uint8_t length;
+    if (chance(random, correctPercent)) {
+      length = comboLength;
+      memcpy(symbols, chance(random, 50) ? secondCombo : firstCombo, length);
+    } else {
+      length = uniform(random, 1, 6);
+      for (uint8_t i = 0; i < length; i++)
+        symbols[i] = uniform(random, 0, comboButtons - 1);
+    }
+    for (uint8_t i = 0; i < length; i++) {
+      // a press too short to count, or the priming button pressed halfway
+      if (chance(random, 4))
+        time = addPress(lock, uniform(random, 0, keyCount - 1), time, uniform(random, 1, 10)) + 5;
+      if (chance(random, 2))
+        time = addPress(lock, 0, time, uniform(random, 20, 300)) + pressGap(lock);
+      time = addPress(lock, 1 + symbols[i], time, uniform(random, 5, 300)) + pressGap(lock);
+    }
+  }
+  // edges of different keys interleave when their bounce overlaps
+  std::stable_sort(lock.edges.begin(), lock.edges.end(),
+                   [](const rawEdge &a, const rawEdge &b) { return a.time < b.time; });
+}
+
+void report(simInstance &lock, unsigned long index, simTotals &totals, uint8_t kind,
+            const char *detail) {
+  totals.violations[kind]++;
+  lock.diverged = true;
+  std::lock_guard<std::mutex> guard(reportLock);
+  if (firstViolations.size() < violationsShown)
+    firstViolations.push_back({index, lock.time, kind, detail});
+}
+
+bool isDue(unsigned long deadline, unsigned long now) { return (long)(now - deadline) >= 0; }
+
+// the lockout after an incorrect combo, or 0 for none
+unsigned long modelLockout(const simInstance &lock) {
+  const lockSettings &s = lock.settings;
+  if (lock.model.failures < s.lockoutFreeAttempts)
+    return 0;
+  uint8_t doublings = lock.model.failures - s.lockoutFreeAttempts;
+  return s.comboInputTimeOut << std::min(doublings, s.lockoutMaxDoublings);
+}
+
+void modelEnterPrimed(lockModel &m) {
+  m.state = LOCK_PRIMED;
+  m.presses = 0;
+  m.open = comboNoAction;
+}
+
+// an incorrect combo is followed by a lockout, or another attempt while the window is open
+void modelAfterIncorrect(simInstance &lock, unsigned long now) {
+  lockModel &m = lock.model;
+  unsigned long lockout = modelLockout(lock);
+  if (lockout != 0) {
+    m.state = LOCK_LOCKED_OUT;
+    m.timing = false;
+    m.flashing = false;
+    m.lockoutEndsAt = now + lockout;
+  } else if (m.timing) {
+    modelEnterPrimed(m);
+  } else {
+    m.state = LOCK_NOT_PRIMED;
+  }
+}
+
+// add a press to the block, true once it is a combo long, with the accessory of the combo it spells
+bool modelCombo(lockModel &m, uint8_t symbol, uint8_t &accessory) {
+  m.entered[m.presses++] = symbol;
+  if (m.presses < comboLength)
+    return false;
+  accessory = comboNoAction;
+  if (memcmp(m.entered, firstCombo, comboLength) == 0)
+    accessory = 0;
+  else if (memcmp(m.entered, secondCombo, comboLength) == 0)
+    accessory = 1;
+  m.presses = 0;
+  return true;
+}
+
+// one pass of the model, with the debounced presses of the pass
+void modelPass(simInstance &lock, unsigned long now, uint8_t pressed) {
+  lockModel &m = lock.model;
+  if (pressed & 1) {
+    if (m.state == LOCK_INCORRECT_COMBO)
+      modelAfterIncorrect(lock, now);  // a lockout that is due isn't skipped by priming
+    if (m.state != LOCK_LOCKED_OUT) {
+      m.timing = true;
+      m.timeOutAt = now + lock.settings.comboInputTimeOut;
+      lock.primedAt = now;
+      modelEnterPrimed(m);
+    }
+  }
+
+  if (m.timing && isDue(m.timeOutAt, now)) {
+    m.timing = false;
+    if (m.state == LOCK_PRIMED)
+      m.state = LOCK_NOT_PRIMED;
+  }
+  if (m.state == LOCK_LOCKED_OUT && isDue(m.lockoutEndsAt, now)) {
+    m.state = LOCK_NOT_PRIMED;
+  }
+
+  if (m.state == LOCK_PRIMED) {
+    uint8_t combo = pressed >> 1;
+    for (uint8_t i = 0; i < comboButtons; i++) {
+      if (!(combo & (1 << i)))
+        continue;
+      uint8_t accessory;
+      if (!modelCombo(m, i, accessory))
+        continue;
+      if (accessory != comboNoAction) {
+        m.state = LOCK_CORRECT_COMBO;
+        m.open = accessory;
+        m.flashing = false;
+        m.timing = false;
+        m.failures = 0;
+      } else {
+        m.state = LOCK_INCORRECT_COMBO;
+        if (m.failures < 0xFF)
+          m.failures++;
+        if (lock.flashCount > 0) {
+          m.flashing = true;
+          m.flashStart = now;
+        }
+      }
+      break;
+    }
+  } else if (m.state == LOCK_INCORRECT_COMBO) {
+    modelAfterIncorrect(lock, now);
+  }
+}
+
+uint8_t modelOutputs(const simInstance &lock, unsigned long now) {
+  const lockModel &m = lock.model;
+  uint8_t levels = 0;
+  if (m.state == LOCK_NOT_PRIMED)
+    levels |= 1 << simLock::blueLed;
+  if (m.state == LOCK_CORRECT_COMBO) {
+    levels |= 1 << simLock::greenLed;
+    levels |= 1 << m.open;
+  }
+  if (m.state == LOCK_LOCKED_OUT) {
+    levels |= 1 << simLock::redLed;
+  } else if (m.flashing) {
+    unsigned long elapsed = now - m.flashStart;
+    bool on = (elapsed / lock.flashInterval) % 2 == 0;
+    if (on && elapsed < 2UL * lock.flashCount * lock.flashInterval)
+      levels |= 1 << simLock::redLed;
+  }
+  return levels;
+}
+
+// the debouncer's edges of this pass against the raw levels
+void checkKeys(simInstance &lock, unsigned long index, simTotals &totals) {
+  uint8_t held = lock.keys.heldMask();
+  uint8_t edges = lock.keys.pressedMask() | lock.keys.releasedMask();
+  uint64_t debounce = lock.settings.comboDebounceTime;
+  for (uint8_t key = 0; key < keyCount; key++) {
+    uint8_t bit = 1 << key;
+    bool steadyFor = lock.time - lock.rawSince[key] >= debounce;
+    char detail[96];
+    if ((edges & bit) && (!steadyFor || (held & bit) != (lock.raw & bit))) {
+      snprintf(detail, sizeof(detail), "key %u reported %s %llu ms after its last change", key,
+               (held & bit) ? "pressed" : "released",
+               (unsigned long long)(lock.time - lock.rawSince[key]));
+      report(lock, index, totals, EARLY_EDGE, detail);
+    } else if (steadyFor && (held & bit) != (lock.raw & bit)) {
+      snprintf(detail, sizeof(detail), "key %u steady for %llu ms but not reported", key,
+               (unsigned long long)(lock.time - lock.rawSince[key]));
+      report(lock, index, totals, MISSED_EDGE, detail);
+    }
+  }
+}
+
+void checkLock(simInstance &lock, unsigned long index, simTotals &totals, unsigned long now) {
+  const simLock &l = lock.locks[0];
+  uint8_t outputs = l.outputs();
+  uint8_t expected = modelOutputs(lock, now);
+  uint8_t accessories = (1 << simAccessories) - 1;
+  char detail[96];
+  if ((outputs & accessories & ~expected) != 0) {
+    snprintf(detail, sizeof(detail), "accessories %02x with the lock %s", outputs & accessories,
+             stateNames[l.state()]);
+    report(lock, index, totals, ACCESSORY_WITHOUT_COMBO, detail);
+  } else if (l.state() == LOCK_PRIMED &&
+             isDue(lock.primedAt + lock.settings.comboInputTimeOut, now)) {
+    snprintf(detail, sizeof(detail), "primed %lu ms ago with a %lu ms timeout",
+             now - lock.primedAt, (unsigned long)lock.settings.comboInputTimeOut);
+    report(lock, index, totals, PRIMED_PAST_TIMEOUT, detail);
+  } else if (l.state() != lock.model.state) {
+    snprintf(detail, sizeof(detail), "lock %s, model %s", stateNames[l.state()],
+             stateNames[lock.model.state]);
+    report(lock, index, totals, WRONG_STATE, detail);
+  } else if (outputs != expected) {
+    snprintf(detail, sizeof(detail), "outputs %02x, model %02x in %s", outputs, expected,
+             stateNames[l.state()]);
+    report(lock, index, totals, WRONG_OUTPUTS, detail);
+  }
+}
+
+// the board is reset while the keys are up: the attempt log survives, a lockout starts over
+void resetLock(simInstance &lock, unsigned long now) {
+  simLock &l = lock.locks[0];
+  l.~simLock();
+  new (&l) simLock(simComboTable, COMBO_BLOCK, lock.settings, lock.history, lock.timers,
+                   lock.flashCount, lock.flashInterval);
+  lock.keys = simKeys();
+  lock.keys.setDebounceTime(lock.settings.comboDebounceTime);
+  l.begin(now);
+  lock.lastState = LOCK_NOT_PRIMED;
+
+  lockModel &m = lock.model;
+  uint8_t failures = m.failures;
+  bool lockedOut = m.state == LOCK_LOCKED_OUT;
+  m = lockModel();
+  m.failures = failures;
+  if (lockedOut) {
+    m.state = LOCK_LOCKED_OUT;
+    m.lockoutEndsAt = now + modelLockout(lock);
+  }
+}
+
+// run a lock up to its next slice boundary, false once it has run its hours
+bool runSlice(simInstance &lock, unsigned long index, simTotals &totals) {
+  uint64_t sliceEnd = std::min(lock.time + sliceTime, lock.endTime);
+  while (lock.time < sliceEnd) {
+    unsigned long now = lock.startClock + (unsigned long)lock.time;
+
+    // the raw levels of this millisecond, then one pass of the sketch's loop
+    while (lock.nextEdge < lock.edges.size() && lock.edges[lock.nextEdge].time <= lock.time) {
+      const rawEdge &e = lock.edges[lock.nextEdge++];
+      uint8_t bit = 1 << e.key;
+      if (((lock.raw & bit) != 0) != (e.level != 0)) {
+        lock.raw ^= bit;
+        lock.rawSince[e.key] = lock.time;
+      }
+      totals.edges++;
+    }
+    lock.keys.setLevels(lock.raw);
+    lock.keys.loop(now);
+    updateLocks(lock.locks, lock.keys, now);
+    totals.passes++;
+
+    if (!lock.diverged) {
+      checkKeys(lock, index, totals);
+      modelPass(lock, now, lock.keys.pressedMask());
+      if (!lock.diverged)
+        checkLock(lock, index, totals, now);
+    }
+    uint8_t state = lock.locks[0].state();
+    totals.transitions[lock.lastState][state] += state != lock.lastState;
+    lock.lastState = state;
+
+    if (lock.nextEdge == lock.edges.size() && scriptEdges.empty()) {
+      if (lock.raw == 0 && chance(lock.random, 2)) {
+        resetLock(lock, now);
+        totals.resets++;
+      }
+      addEpisode(lock);
+    }
+
+    // the next millisecond while a key is bouncing or the lock has something due, otherwise skip
+    // ahead to whichever comes first of the next edge and the lock's next deadline
+    uint64_t next = lock.endTime;
+    if (lock.nextEdge < lock.edges.size())
+      next = std::min(next, lock.edges[lock.nextEdge].time);
+    unsigned long wait = lock.locks[0].timeUntilNextEvent(now);
+    if (wait != noDeadline)
+      next = std::min(next, lock.time + std::max(wait, 1UL));
+    if (lock.keys.heldMask() != lock.raw)
+      next = lock.time + 1;
+    totals.simulatedMs += next - lock.time;
+    lock.time = next;
+  }
+  return lock.time < lock.endTime;
+}
+
+// per-thread queues of lock indexes, owners take from the back and thieves from the front
+class workStealingPool {
+ public:
+  workStealingPool(unsigned threads, std::vector<simInstance *> &locks)
+      : locks(locks), queues(threads), remaining(locks.size()) {
+    // contiguous shards, one per thread
+    size_t shard = (locks.size() + threads - 1) / threads;
+    for (size_t i = 0; i < locks.size(); i++)
+      queues[i / shard].tasks.push_back(i);
+  }
+
+  void run(std::vector<simTotals> &totals) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < queues.size(); t++)
+      workers.emplace_back([this, t, &totals] { work(t, totals[t]); });
+    for (std::thread &w : workers)
+      w.join();
+  }
+
+ private:
+  struct workQueue {
+    std::mutex lock;
+    std::deque<size_t> tasks;
+  };
+
+  std::vector<simInstance *> &locks;
+  std::vector<workQueue> queues;
+  std::atomic<size_t> remaining;
+
+  bool take(unsigned t, size_t &task) {
+    std::lock_guard<std::mutex> guard(queues[t].lock);
+    if (queues[t].tasks.empty())
+      return false;
+    task = queues[t].tasks.back();
+    queues[t].tasks.pop_back();
+    return true;
+  }
+
+  bool steal(unsigned t, size_t &task) {
+    for (unsigned i = 1; i < queues.size(); i++) {
+      workQueue &victim = queues[(t + i) % queues.size()];
+      std::lock_guard<std::mutex> guard(victim.lock);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.front();
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(unsigned t, simTotals &totals) {
+    while (remaining.load() > 0) {
+      size_t task;
+      if (!take(t, task)) {
+        if (!steal(t, task)) {
+          std::this_thread::yield();
+          continue;
+        }
+        totals.stolen++;
+      }
+      totals.slices++;
+      if (runSlice(*locks[task], task, totals)) {
+        std::lock_guard<std::mutex> guard(queues[t].lock);
+        queues[t].tasks.push_front(task);  // behind the others, so every lock moves along
+      } else {
+        remaining--;
+      }
+    }
+  }
+};
+
+bool readScript(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL)
+    return false;
+  unsigned long time, pin, level;
+  char line[128];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (sscanf(line, "%lu %lu %lu", &time, &pin, &level) != 3)
+      continue;
+    for (uint8_t key = 0; key < keyCount; key++) {
+      if (keyPins[key] == pin)
+        scriptEdges.push_back({time, key, (uint8_t)(level != 0)});
+    }
+  }
+  fclose(file);
+  std::stable_sort(scriptEdges.begin(), scriptEdges.end(),
+                   [](const rawEdge &a, const rawEdge &b) { return a.time < b.time; });
+  return !scriptEdges.empty();
+}
+
+simInstance *makeInstance(unsigned long index, const simOptions &options) {
+  std::mt19937_64 random(options.seed * 0x9E3779B97F4A7C15ULL + index);
+  lockSettings s;
+  s.comboInputTimeOut = uniform(random, 1000, 30000);
+  s.primingDebounceTime = s.comboDebounceTime = uniform(random, 0, 80);
+  s.lockoutFreeAttempts = uniform(random, 1, 4);
+  s.lockoutMaxDoublings = uniform(random, 0, 4);
+  uint8_t flashCount = uniform(random, 0, 6);
+  uint16_t flashInterval = uniform(random, 20, 200);
+
+  simInstance *lock = new simInstance(s, flashCount, flashInterval);
+  lock->random = random;
+  lock->keys.setDebounceTime(s.comboDebounceTime);
+  // an eighth start within a few hours of millis() wrapping around
+  if (chance(lock->random, 12))
+    lock->startClock = 0UL - (unsigned long)uniform(lock->random, 0, 4 * msPerHour);
+  else
+    lock->startClock = lock->random();
+  lock->endTime = (uint64_t)(options.hours * msPerHour);
+  lock->locks[0].begin(lock->startClock);
+  if (!scriptEdges.empty())
+    lock->edges = scriptEdges;
+  else
+    addEpisode(*lock);
+  return lock;
+}
+
+bool parseOptions(int argc, char **argv, simOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--locks") == 0 && hasValue)
+      options.locks = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--hours") == 0 && hasValue)
+      options.hours = strtod(argv[++i], NULL);
+    else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+      options.threads = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+      options.seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--correct") == 0 && hasValue)
+      options.correctPercent = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--script") == 0 && hasValue)
+      options.script = argv[++i];
+    else
+      return false;
+  }
+  return options.locks > 0 && options.hours > 0 && options.correctPercent <= 100;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  simOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr,
+            "usage: %s [--locks n] [--hours n] [--threads n] [--seed n] [--correct percent] "
+            "[--script file]\n",
+            argv[0]);
+    return 2;
+  }
+  if (options.script != NULL && !readScript(options.script)) {
+    fprintf(stderr, "no key presses read from %s\n", options.script);
+    return 2;
+  }
+  correctPercent = options.correctPercent;
+  unsigned threads = options.threads;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<unsigned long>(threads, options.locks);
+
+  std::vector<simInstance *> locks;
+  for (unsigned long i = 0; i < options.locks; i++)
+    locks.push_back(makeInstance(i, options));
+
+  std::vector<simTotals> perThread(threads);
+  workStealingPool pool(threads, locks);
+  hostClock::time_point start = hostClock::now();
+  pool.run(perThread);
+  double seconds = std::chrono::duration<double>(hostClock::now() - start).count();
+
+  simTotals totals;
+  for (const simTotals &t : perThread) {
+    totals.passes += t.passes;
+    totals.edges += t.edges;
+    totals.simulatedMs += t.simulatedMs;
+    totals.slices += t.slices;
+    totals.stolen += t.stolen;
+    totals.resets += t.resets;
+    for (uint8_t a = 0; a < LOCK_STATE_COUNT; a++)
+      for (uint8_t b = 0; b < LOCK_STATE_COUNT; b++)
+        totals.transitions[a][b] += t.transitions[a][b];
+    for (uint8_t k = 0; k < VIOLATION_KINDS; k++)
+      totals.violations[k] += t.violations[k];
+  }
+
+  double hours = totals.simulatedMs / (double)msPerHour;
+  printf("%lu locks, %.0f simulated hours on %u threads in %.2f s\n", options.locks, hours, threads,
+         seconds);
+  printf("%llu passes (%.1f million/s), %llu key edges, %.0f simulated hours/s\n",
+         (unsigned long long)totals.passes, totals.passes / seconds / 1e6,
+         (unsigned long long)totals.edges, hours / seconds);
+  printf("%llu slices, %llu stolen, %llu resets\n\n", (unsigned long long)totals.slices,
+         (unsigned long long)totals.stolen, (unsigned long long)totals.resets);
+
+  printf("%-16s %-16s %14s\n", "from", "to", "transitions");
+  unsigned unseen = 0;
+  for (uint8_t a = 0; a < LOCK_STATE_COUNT; a++) {
+    for (uint8_t b = 0; b < LOCK_STATE_COUNT; b++) {
+      uint64_t n = totals.transitions[a][b];
+      if (n == 0 && !expectedTransitions[a][b])
+        continue;
+      printf("%-16s %-16s %14llu%s\n", stateNames[a], stateNames[b], (unsigned long long)n,
+             expectedTransitions[a][b] ? (n == 0 ? "  not covered" : "") : "  unexpected");
+      unseen += n == 0;
+    }
+  }
+  printf("%u expected transitions not covered\n\n", unseen);
+
+  uint64_t violations = 0;
+  for (uint8_t k = 0; k < VIOLATION_KINDS; k++) {
+    violations += totals.violations[k];
+    if (totals.violations[k] > 0)
+      printf("%-40s %llu locks\n", violationNames[k], (unsigned long long)totals.violations[k]);
+  }
+  for (const violation &v : firstViolations)
+    printf("  lock %lu at %.3f h: %s, %s\n", v.lock, v.time / (double)msPerHour,
+           violationNames[v.kind], v.detail.c_str());
+  printf("%llu invariant violations\n", (unsigned long long)violations);
+
+  for (simInstance *lock : locks)
+    delete lock;
+  return violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/*
+  gestureBench.cpp
+
+  Timing check of the gesture layer (buttonGestures.h), run on the host by the native core's own
+  runner, which plays src/bench/gestureBench.txt on the key pins:
+
+  pio run -e bench_gestures &&
+    .pio/build/bench_gestures/program --script src/bench/gestureBench.txt --run-ms 20000
+
+  Three keys on pins 9 to 11 are debounced by a buttonGroup for 10 ms and fed to buttonGestures
+  every pass, with a 600 ms long-press time and a 250 ms multi-click time. The script presses them
+  on either side of each timing edge, and every gesture read is checked against the list below for
+  its type, keys and clicks, its time, which is when the first key of the gesture went down, and
+  the time it was read:
+
+  - a key held for the long-press time is a click, as the release is seen in the scan the
+    long-press would be due; held a millisecond longer it is a long-press, reported the moment
+    the long-press time is up, and its release reports nothing
+  - clicks less than the multi-click time apart are one double click, reported the multi-click
+    time after the last release; clicks the multi-click time apart are two single clicks, the
+    first reported in the scan the second press is seen
+  - a click followed by a long-press of the same key is a long-press counting both
+  - keys pressed before the others are released are one chord, both as a click and as a long-press
+  - a click of other keys reports the clicks waiting before it on its release
+  - contact bounce on either edge of a click makes neither a double click nor a later gesture
+
+  The check stops itself once the script is over. Failed checks are listed and make the program
+  exit with status 1, as does ending the run before the script, or running without it.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <buttonGestures.h>
+#include <buttonGroup.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+const uint8_t keyCount = 3;
+const uint8_t keyPins[keyCount] = {9, 10, 11};  // pull-down, so pressed reads HIGH
+const unsigned long debounceTime = 10;
+const uint16_t longPressTime = 600;
+const uint16_t multiClickTime = 250;
+const unsigned long scriptEnd = 19000;  // ms, well after the last gesture of the script
+
+// a gesture the script should give; the times are those of the script plus the debounce time
+struct expectedGesture {
+  const char *name;  // the script's case
+  unsigned long readAt;
+  uint8_t type;
+  uint8_t keys;
+  uint8_t clicks;
+  unsigned long time;
+};
+
+const expectedGesture expected[] = {
+    {"long-press, just short", 1860, GESTURE_CLICK, 0x1, 1, 1010},
+    {"long-press, just long enough", 3610, GESTURE_LONG_PRESS, 0x1, 1, 3010},
+    {"double click", 5709, GESTURE_CLICK, 0x2, 2, 5010},
+    {"double click, just too slow", 7360, GESTURE_CLICK, 0x2, 1, 7010},
+    {"double click, just too slow", 7710, GESTURE_CLICK, 0x2, 1, 7360},
+    {"click then long-press", 9810, GESTURE_LONG_PRESS, 0x4, 2, 9010},
+    {"chord", 11460, GESTURE_CLICK, 0x3, 1, 11010},
+    {"chord long-press", 13610, GESTURE_LONG_PRESS, 0x5, 1, 13010},
+    {"other keys", 15310, GESTURE_CLICK, 0x1, 1, 15010},
+    {"other keys", 15560, GESTURE_CLICK, 0x2, 1, 15210},
+    {"bounce", 17365, GESTURE_CLICK, 0x4, 1, 17014},
+};
+const uint8_t expectedCount = sizeof(expected) / sizeof(expected[0]);
+
+enum failureKind { WRONG_GESTURE,
+                   GESTURE_TIME,
+                   READ_TIME,
+                   EXTRA,
+                   MISSING,
+                   FAILURE_KINDS };
+
+const char *const failureNames[FAILURE_KINDS] = {"wrong gesture", "gesture time", "read time",
+                                                 "extra gesture", "missing gesture"};
+
+struct tally {
+  unsigned long checks = 0;
+  unsigned long failures[FAILURE_KINDS] = {};
+};
+
+buttonGroup<keyCount> keys(keyPins, INPUT, false);
+buttonGestures<keyCount> gestures;
+tally t;
+uint8_t nextExpected = 0;
+bool finished = false;
+
+void check(failureKind kind, bool passed, const char *name) {
+  t.checks++;
+  if (!passed) {
+    t.failures[kind]++;
+    printf("  %s: %s\n", failureNames[kind], name);
+  }
+}
+
+const char *typeName(uint8_t type) { return type == GESTURE_LONG_PRESS ? "long-press" : "click"; }
+
+void checkGesture(const gesture &g, unsigned long now) {
+  printf("%6lu ms  %-10s keys 0x%x  clicks %u  from %lu ms\n", now, typeName(g.type), g.keys,
+         g.clicks, g.time);
+  if (nextExpected == expectedCount) {
+    check(EXTRA, false, "after the last case");
+    return;
+  }
+  const expectedGesture &e = expected[nextExpected++];
+  check(WRONG_GESTURE, g.type == e.type && g.keys == e.keys && g.clicks == e.clicks, e.name);
+  check(GESTURE_TIME, g.time == e.time, e.name);
+  check(READ_TIME, now >= e.readAt && now <= e.readAt + 1, e.name);
+}
+
+int report(void) {
+  for (; nextExpected < expectedCount; nextExpected++)
+    check(MISSING, false, expected[nextExpected].name);
+
+  unsigned long failures = 0;
+  for (uint8_t kind = 0; kind < FAILURE_KINDS; kind++)
+    failures += t.failures[kind];
+  printf("\n%lu checks, %lu failed checks\n", t.checks, failures);
+  return failures == 0 ? 0 : 1;
+}
+
+// the runner returns when its run time is up, which may be before the script is over
+void endedEarly(void) {
+  if (finished)
+    return;
+  printf("\nthe run ended at %lu ms, before the script, run with --run-ms %lu or more\n", millis(),
+         scriptEnd);
+  report();
+  fflush(stdout);
+  _exit(1);
+}
+
+}  // namespace
+
+void setup() {
+  keys.setDebounceTime(debounceTime);
+  gestures.setLongPressTime(longPressTime);
+  gestures.setMultiClickTime(multiClickTime);
+  atexit(endedEarly);
+  printf("%u keys, debounce %lu ms, long-press %u ms, multi-click %u ms\n\n", keyCount,
+         debounceTime, longPressTime, multiClickTime);
+}
+
+void loop() {
+  unsigned long now = millis();
+  keys.loop(now);
+  gestures.update(keys, now);
+  gesture g;
+  while (gestures.read(g))
+    checkGesture(g, now);
+
+  if (now >= scriptEnd) {
+    finished = true;
+    exit(report());
+  }
+}
@@ -0,0 +1,351 @@
+/*
+  keypadBench.cpp
+
+  Check of the matrix keypad scanner (keypadMatrix.h), run on the host with the native core (pio
+  run -e bench_keypad). A 4x4 keypad is wired up with the native core's switches between row and
+  column pins, and keys are closed and opened on it while keypad.loop() is called every loop
+  interval. It checks that:
+
+  - every single key is reported pressed and released once, at its own index and no other, no
+    sooner than the debounce time after it closed and no later than a millisecond and one pass
+    after that, and is held in between
+  - contact bounce shorter than the debounce time is never reported, and a bouncing key is
+    reported once, no sooner than the debounce time after its first contact and no later than a
+    millisecond and one pass after the debounce time from when it settled
+  - a key that completes a rectangle with keys already held is ignored, the keys held stay held,
+    the fourth corner, the ghost, is never reported, and ghosted() says so; once another corner is
+    released the rectangle is broken and the key that completed it is reported
+  - three keys in one row are not mistaken for a rectangle
+  - with a scan interval the matrix is scanned once per interval however often loop() is called,
+    a press is reported on a single call, and no later than the debounce time and one interval
+    after the key closed
+
+  Options:
+  --loop-us <us>       virtual time between loop() calls (default 100)
+  --interval <ms>      scan interval for the scan interval checks (default 5)
+
+  Failed checks are listed and make the program exit with status 1.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <keypadMatrix.h>
+
+#include <stdio.h>
+
+namespace {
+
+const uint8_t keypadRows = 4;
+const uint8_t keypadCols = 4;
+const uint8_t keypadKeys = keypadRows * keypadCols;
+const uint8_t keypadPins[] = {2, 3, 4, 5,   // rows
+                              6, 7, 8, 9};  // columns
+const unsigned long debounceTime = 20;
+const uint64_t settleMicros = 60000;  // long enough for any key to be reported
+
+typedef keypadMatrix<keypadRows, keypadCols> benchKeypad;
+
+struct benchOptions {
+  unsigned long loopMicros = 100;
+  unsigned long scanInterval = 5;
+};
+
+enum failureKind { SINGLE_KEY,
+                   BOUNCE,
+                   GHOST,
+                   SAME_ROW,
+                   SCAN_INTERVAL,
+                   FAILURE_KINDS };
+
+const char *const failureNames[FAILURE_KINDS] = {"single key", "contact bounce", "ghost rectangle",
+                                                 "keys in one row", "scan interval"};
+
+struct tally {
+  unsigned long checks = 0;
+  unsigned long failures[FAILURE_KINDS] = {};
+};
+
+void check(tally &t, failureKind kind, bool passed, const char *detail) {
+  t.checks++;
+  if (!passed) {
+    t.failures[kind]++;
+    printf("  %s: %s\n", failureNames[kind], detail);
+  }
+}
+
+uint32_t keyBit(uint8_t row, uint8_t column) {
+  return (uint32_t)1 << benchKeypad::keyIndex(row, column);
+}
+
+void setKey(uint8_t row, uint8_t column, bool closed) {
+  nativeHal::setSwitch(keypadPins[row], keypadPins[keypadRows + column], closed);
+}
+
+// what the keypad reported over a stretch of loop() calls
+struct scanLog {
+  unsigned presses[keypadKeys] = {};   // calls with isPressed() true
+  unsigned releases[keypadKeys] = {};  // calls with isReleased() true
+  uint64_t firstPress[keypadKeys] = {};
+  unsigned long calls = 0;
+  unsigned long scans = 0;
+  bool ghosted = false;  // after any scan
+
+  uint32_t pressedKeys(void) const {
+    uint32_t keys = 0;
+    for (uint8_t k = 0; k < keypadKeys; k++)
+      keys |= (uint32_t)(presses[k] != 0) << k;
+    return keys;
+  }
+};
+
+// call loop() every loop interval for a while; the native settle delay advances the clock, so a
+// call that took time scanned the matrix
+void run(benchKeypad &keypad, uint64_t micros, const benchOptions &options, scanLog &log) {
+  uint64_t end = nativeHal::now() + micros;
+  while (nativeHal::now() < end) {
+    uint64_t before = nativeHal::now();
+    keypad.loop();
+    log.calls++;
+    if (nativeHal::now() != before) {
+      log.scans++;
+      log.ghosted |= keypad.ghosted();
+    }
+    for (uint8_t k = 0; k < keypadKeys; k++) {
+      if (keypad.isPressed(k) && log.presses[k]++ == 0)
+        log.firstPress[k] = nativeHal::now();
+      log.releases[k] += keypad.isReleased(k);
+    }
+    nativeHal::advance(options.loopMicros);
+  }
+}
+
+// the press is reported from the debounce time after the key closed, within a millisecond of
+// millis() resolution and a pass of the loop
+bool inTime(uint64_t reportedAt, uint64_t closedAt, uint64_t latest) {
+  uint64_t earliest = (debounceTime - 1) * 1000;
+  return reportedAt >= closedAt + earliest && reportedAt <= closedAt + latest;
+}
+
+void checkSingleKeys(tally &t, const benchOptions &options) {
+  nativeHal::reset();
+  benchKeypad keypad(keypadPins);
+  keypad.setDebounceTime(debounceTime);
+  char detail[96];
+
+  for (uint8_t r = 0; r < keypadRows; r++) {
+    for (uint8_t c = 0; c < keypadCols; c++) {
+      uint8_t k = benchKeypad::keyIndex(r, c);
+      scanLog pressing;
+      uint64_t closedAt = nativeHal::now();
+      setKey(r, c, true);
+      run(keypad, settleMicros, options, pressing);
+      snprintf(detail, sizeof(detail), "key %u pressed %u times, keys 0x%04lx reported", k,
+               pressing.presses[k], (unsigned long)pressing.pressedKeys());
+      check(t, SINGLE_KEY, pressing.pressedKeys() == keyBit(r, c) && pressing.presses[k] == 1,
+            detail);
+      snprintf(detail, sizeof(detail), "key %u reported %lld us after closing", k,
+               (long long)(pressing.firstPress[k] - closedAt));
+      uint64_t latest = (debounceTime + 1) * 1000 + options.loopMicros;
+      check(t, SINGLE_KEY, inTime(pressing.firstPress[k], closedAt, latest), detail);
+      snprintf(detail, sizeof(detail), "key %u held with keys 0x%04lx", k,
+               (unsigned long)keypad.heldMask());
+      check(t, SINGLE_KEY, keypad.heldMask() == keyBit(r, c), detail);
+      snprintf(detail, sizeof(detail), "%lu scans in %lu calls without a scan interval",
+               pressing.scans, pressing.calls);
+      check(t, SINGLE_KEY, pressing.scans == pressing.calls, detail);
+
+      scanLog releasing;
+      setKey(r, c, false);
+      run(keypad, settleMicros, options, releasing);
+      snprintf(detail, sizeof(detail), "key %u released %u times, %lu presses after", k,
+               releasing.releases[k], (unsigned long)releasing.pressedKeys());
+      check(t, SINGLE_KEY,
+            releasing.releases[k] == 1 && releasing.pressedKeys() == 0 && keypad.heldMask() == 0,
+            detail);
+    }
+  }
+}
+
+// a switch that makes and breaks contact a few times, settling closed or open
+void bounceKey(uint8_t row, uint8_t column, bool settle, uint64_t start) {
+  const uint64_t offsets[] = {0, 300, 700, 1500, 2000};
+  const uint8_t rowPin = keypadPins[row];
+  const uint8_t columnPin = keypadPins[keypadRows + column];
+  for (uint8_t i = 0; i < 5; i++)
+    nativeHal::scheduleSwitch(rowPin, columnPin, start + offsets[i], i % 2 == 0 ? settle : !settle);
+}
+
+void checkBounce(tally &t, const benchOptions &options) {
+  nativeHal::reset();
+  benchKeypad keypad(keypadPins);
+  keypad.setDebounceTime(debounceTime);
+  const uint8_t k = benchKeypad::keyIndex(2, 3);
+  const uint64_t settledAfter = 2000;
+  char detail[96];
+
+  uint64_t start = nativeHal::now() + 1000;
+  bounceKey(2, 3, true, start);
+  scanLog pressing;
+  run(keypad, settleMicros, options, pressing);
+  snprintf(detail, sizeof(detail), "%u presses of a bouncing key, reported %lld us after settling",
+           pressing.presses[k], (long long)(pressing.firstPress[k] - start - settledAfter));
+  check(t, BOUNCE,
+        pressing.pressedKeys() == keyBit(2, 3) && pressing.presses[k] == 1 &&
+            inTime(pressing.firstPress[k], start,
+                   settledAfter + (debounceTime + 1) * 1000 + options.loopMicros),
+        detail);
+
+  start = nativeHal::now() + 1000;
+  bounceKey(2, 3, false, start);
+  scanLog releasing;
+  run(keypad, settleMicros, options, releasing);
+  snprintf(detail, sizeof(detail), "%u releases and %u presses of a bouncing key",
+           releasing.releases[k], releasing.presses[k]);
+  check(t, BOUNCE, releasing.releases[k] == 1 && releasing.pressedKeys() == 0, detail);
+}
+
+void checkGhost(tally &t, const benchOptions &options) {
+  nativeHal::reset();
+  benchKeypad keypad(keypadPins);
+  keypad.setDebounceTime(debounceTime);
+  const uint32_t held = keyBit(0, 0) | keyBit(0, 1);
+  const uint8_t completing = benchKeypad::keyIndex(1, 0);
+  char detail[96];
+
+  // two keys of a row, then the key below one of them completes the rectangle: with it closed the
+  // fourth corner reads as closed too, and neither can be told from a real press
+  scanLog pair;
+  setKey(0, 0, true);
+  setKey(0, 1, true);
+  run(keypad, settleMicros, options, pair);
+  snprintf(detail, sizeof(detail), "keys 0x%04lx reported, 0x%04lx held",
+           (unsigned long)pair.pressedKeys(), (unsigned long)keypad.heldMask());
+  check(t, GHOST, pair.pressedKeys() == held && keypad.heldMask() == held && !pair.ghosted,
+        detail);
+
+  scanLog rectangle;
+  setKey(1, 0, true);
+  run(keypad, settleMicros, options, rectangle);
+  snprintf(detail, sizeof(detail), "keys 0x%04lx reported, 0x%04lx held with the rectangle",
+           (unsigned long)rectangle.pressedKeys(), (unsigned long)keypad.heldMask());
+  check(t, GHOST, rectangle.pressedKeys() == 0 && keypad.heldMask() == held, detail);
+  check(t, GHOST, rectangle.ghosted && keypad.ghosted(), "ghosted() not set by the rectangle");
+
+  // releasing a corner breaks the rectangle, and the key that completed it is reported
+  scanLog broken;
+  setKey(0, 0, false);
+  run(keypad, settleMicros, options, broken);
+  uint32_t left = keyBit(0, 1) | keyBit(1, 0);
+  snprintf(detail, sizeof(detail),
+           "%u releases of the corner, %u presses of the completing key, 0x%04lx held",
+           broken.releases[0], broken.presses[completing], (unsigned long)keypad.heldMask());
+  check(t, GHOST,
+        broken.releases[0] == 1 && broken.pressedKeys() == keyBit(1, 0) &&
+            broken.presses[completing] == 1 && keypad.heldMask() == left,
+        detail);
+  check(t, GHOST, !keypad.ghosted(), "ghosted() still set after the rectangle broke");
+
+  scanLog clear;
+  setKey(0, 1, false);
+  setKey(1, 0, false);
+  run(keypad, settleMicros, options, clear);
+  check(t, GHOST, keypad.heldMask() == 0 && clear.pressedKeys() == 0,
+        "keys still held after all were released");
+}
+
+void checkSameRow(tally &t, const benchOptions &options) {
+  nativeHal::reset();
+  benchKeypad keypad(keypadPins);
+  keypad.setDebounceTime(debounceTime);
+  const uint32_t row = keyBit(3, 0) | keyBit(3, 1) | keyBit(3, 2);
+  char detail[96];
+
+  scanLog log;
+  for (uint8_t c = 0; c < 3; c++) {
+    setKey(3, c, true);
+    run(keypad, settleMicros, options, log);
+  }
+  snprintf(detail, sizeof(detail), "keys 0x%04lx reported, 0x%04lx held",
+           (unsigned long)log.pressedKeys(), (unsigned long)keypad.heldMask());
+  check(t, SAME_ROW, log.pressedKeys() == row && keypad.heldMask() == row && !log.ghosted, detail);
+}
+
+void checkScanInterval(tally &t, const benchOptions &options) {
+  nativeHal::reset();
+  benchKeypad keypad(keypadPins);
+  keypad.setDebounceTime(debounceTime);
+  keypad.setScanInterval(options.scanInterval);
+  const uint8_t k = benchKeypad::keyIndex(2, 1);
+  char detail[96];
+
+  // one scan per interval, give or take the one at either end
+  scanLog idle;
+  const unsigned long idleMs = 100;
+  run(keypad, idleMs * 1000, options, idle);
+  unsigned long expected = idleMs / options.scanInterval;
+  snprintf(detail, sizeof(detail), "%lu scans in %lu ms, expected %lu to %lu", idle.scans, idleMs,
+           expected - 1, expected + 1);
+  check(t, SCAN_INTERVAL, idle.scans + 1 >= expected && idle.scans <= expected + 1, detail);
+
+  scanLog pressing;
+  uint64_t closedAt = nativeHal::now();
+  setKey(2, 1, true);
+  run(keypad, settleMicros, options, pressing);
+  snprintf(detail, sizeof(detail), "pressed on %u calls, reported %lld us after closing",
+           pressing.presses[k], (long long)(pressing.firstPress[k] - closedAt));
+  check(t, SCAN_INTERVAL,
+        pressing.pressedKeys() == keyBit(2, 1) && pressing.presses[k] == 1 &&
+            inTime(pressing.firstPress[k], closedAt,
+                   (debounceTime + options.scanInterval + 1) * 1000 + options.loopMicros),
+        detail);
+
+  scanLog releasing;
+  setKey(2, 1, false);
+  run(keypad, settleMicros, options, releasing);
+  snprintf(detail, sizeof(detail), "released on %u calls", releasing.releases[k]);
+  check(t, SCAN_INTERVAL, releasing.releases[k] == 1 && keypad.heldMask() == 0, detail);
+}
+
+bool parseOptions(int argc, char **argv, benchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--loop-us") == 0 && hasValue)
+      options.loopMicros = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--interval") == 0 && hasValue)
+      options.scanInterval = strtoul(argv[++i], NULL, 10);
+    else
+      return false;
+  }
+  return options.loopMicros > 0 && options.loopMicros < 1000 && options.scanInterval > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr, "usage: %s [--loop-us 1-999] [--interval ms]\n", argv[0]);
+    return 2;
+  }
+  printf("%ux%u keypad, debounce %lu ms, loop every %lu us, scan interval %lu ms\n\n", keypadRows,
+         keypadCols, debounceTime, options.loopMicros, options.scanInterval);
+
+  tally t;
+  checkSingleKeys(t, options);
+  checkBounce(t, options);
+  checkGhost(t, options);
+  checkSameRow(t, options);
+  checkScanInterval(t, options);
+
+  unsigned long failures = 0;
+  for (uint8_t kind = 0; kind < FAILURE_KINDS; kind++)
+    failures += t.failures[kind];
+  printf("\n%lu checks, %lu failed checks\n", t.checks, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+/*
+  linkLatencyBench.cpp
+
+  Round-trip latency benchmark for the serial link (lockLink.h), run on the host with the native
+  core (pio run -e bench_link_latency). The whole lock sketch runs with -D LOCK_LINK, its Serial
+  attached to a pseudo terminal, and a host thread on the other side of the terminal plays the part
+  of a tool on a PC: it sends requests one at a time and waits for each reply, timing the round
+  trip with the host's clock and counting the passes of the loop it took.
+
+  Requests cycle through pings with an 8 byte payload, telemetry and reading the settings, with a
+  setting changed every 50 requests and a burst of line noise sent before every 20th request, so
+  resynchronisation is exercised along the way. The noise ends with the start of a frame that never
+  finishes, which holds up the request after it until the link gives up on the unfinished frame.
+  Every reply is checked against its request.
+
+  For each kind of request it prints the number sent and the round trip percentiles in
+  microseconds, and the mean and largest number of loop passes between sending a request and
+  receiving its reply. At the end the link's own counters are read back by telemetry, and the
+  settings are read back to check the last change took. The exit status is non-zero if any reply
+  was missing or wrong.
+
+  The sketch's clock is virtual, so by default the loop runs as fast as the host allows and
+  virtual time races ahead; --realtime holds virtual time to the host's clock instead, so the
+  lock's timers behave as on a board, at the cost of sleeping between passes.
+
+  Options:
+  --requests <n>       requests to send (default 3000)
+  --loop-us <us>       virtual time each pass of loop() takes (default 10)
+  --realtime           keep virtual time in step with the host's clock
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <frameLink.h>
+#include <lockConfig.h>
+#include <lockLink.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef LOCK_LINK
+#error "the link latency benchmark needs -D LOCK_LINK"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock hostClock;
+
+const int replyTimeoutMs = 1000;
+const uint8_t pingPayload = 8;
+const unsigned long settingEvery = 50;
+const unsigned long noiseEvery = 20;
+
+struct benchOptions {
+  unsigned long requests = 3000;
+  unsigned long loopMicros = 10;
+  bool realtime = false;
+};
+
+struct requestKind {
+  const char *name;
+  std::vector<double> roundTrips;  // microseconds
+  std::vector<uint64_t> passes;
+};
+
+std::atomic<uint64_t> loopPasses(0);
+std::atomic<bool> hostDone(false);
+
+// the host's end of the link
+class hostLink {
+ public:
+  explicit hostLink(int fd) : fd(fd) {}
+
+  bool send(const std::vector<uint8_t> &payload) {
+    std::vector<uint8_t> frame;
+    frame.push_back(frameSync);
+    frame.push_back(payload.size());
+    uint8_t crc = frameCrc8(0, payload.size());
+    for (uint8_t b : payload) {
+      frame.push_back(b);
+      crc = frameCrc8(crc, b);
+    }
+    frame.push_back(crc);
+    return writeAll(frame);
+  }
+
+  bool writeAll(const std::vector<uint8_t> &bytes) {
+    size_t done = 0;
+    while (done < bytes.size()) {
+      ssize_t n = write(fd, bytes.data() + done, bytes.size() - done);
+      if (n <= 0)
+        return false;
+      done += n;
+    }
+    return true;
+  }
+
+  // the next good frame's payload, false on timeout
+  bool receive(std::vector<uint8_t> &payload) {
+    hostClock::time_point deadline = hostClock::now() + std::chrono::milliseconds(replyTimeoutMs);
+    for (;;) {
+      if (takeFrame(payload))
+        return true;
+      int left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - hostClock::now())
+                     .count();
+      if (left <= 0)
+        return false;
+      struct pollfd pending = {fd, POLLIN, 0};
+      if (poll(&pending, 1, left) <= 0)
+        return false;
+      uint8_t chunk[256];
+      ssize_t n = read(fd, chunk, sizeof(chunk));
+      if (n <= 0)
+        return false;
+      buffer.insert(buffer.end(), chunk, chunk + n);
+    }
+  }
+
+ private:
+  int fd;
+  std::vector<uint8_t> buffer;
+
+  bool takeFrame(std::vector<uint8_t> &payload) {
+    while (!buffer.empty()) {
+      if (buffer[0] != frameSync) {
+        buffer.erase(buffer.begin());
+        continue;
+      }
+      if (buffer.size() < 2 || buffer.size() < (size_t)buffer[1] + frameOverhead)
+        return false;
+      uint8_t length = buffer[1];
+      uint8_t crc = frameCrc8(0, length);
+      for (uint8_t i = 0; i < length; i++)
+        crc = frameCrc8(crc, buffer[2 + i]);
+      if (crc != buffer[2 + length]) {
+        buffer.erase(buffer.begin());
+        continue;
+      }
+      payload.assign(buffer.begin() + 2, buffer.begin() + 2 + length);
+      buffer.erase(buffer.begin(), buffer.begin() + 2 + length + 1);
+      return true;
+    }
+    return false;
+  }
+};
+
+struct hostResults {
+  requestKind kinds[4] = {{"ping", {}, {}}, {"telemetry", {}, {}}, {"get settings", {}, {}},
+                          {"set setting", {}, {}}};
+  unsigned long missing = 0;
+  unsigned long wrong = 0;
+  uint16_t linkFrames = 0;
+  uint16_t linkBadFrames = 0;
+  uint16_t linkOverruns = 0;
+  bool settingKept = false;
+};
+
+uint32_t little32(const std::vector<uint8_t> &bytes, size_t at) {
+  return bytes[at] | (bytes[at + 1] << 8) | (bytes[at + 2] << 16) | ((uint32_t)bytes[at + 3] << 24);
+}
+
+// one request and its reply, timed; the reply is checked by the caller
+bool exchange(hostLink &link, const std::vector<uint8_t> &request, std::vector<uint8_t> &reply,
+              requestKind &kind, hostResults &results) {
+  hostClock::time_point start = hostClock::now();
+  uint64_t startPasses = loopPasses.load();
+  if (!link.send(request) || !link.receive(reply)) {
+    results.missing++;
+    return false;
+  }
+  double micros = std::chrono::duration<double, std::micro>(hostClock::now() - start).count();
+  kind.roundTrips.push_back(micros);
+  kind.passes.push_back(loopPasses.load() - startPasses);
+  if (reply.size() < 3 || reply[0] != (request[0] | linkReplyFlag) || reply[1] != request[1] ||
+      reply[2] != LINK_DONE) {
+    results.wrong++;
+    return false;
+  }
+  return true;
+}
+
+void runHost(int fd, const benchOptions &options, hostResults &results) {
+  hostLink link(fd);
+  std::vector<uint8_t> reply;
+  uint32_t lastTimeout = 0;
+  for (unsigned long i = 0; i < options.requests; i++) {
+    uint8_t tag = i;
+    // a frame too long for the ring, then one cut off that only the link's timeout ends
+    if (i % noiseEvery == noiseEvery - 1)
+      link.writeAll({0x00, frameSync, 0xFF, frameSync, 0x30, 0x13});
+
+    if (i % settingEvery == settingEvery - 1) {
+      lastTimeout = i % (2 * settingEvery) == settingEvery - 1 ? 20000 : 10000;
+      std::vector<uint8_t> request = {LINK_SET_SETTING, tag, CONFIG_COMBO_TIMEOUT};
+      for (int b = 0; b < 4; b++)
+        request.push_back(lastTimeout >> (8 * b));
+      if (exchange(link, request, reply, results.kinds[3], results) &&
+          (reply.size() != 7 || little32(reply, 3) != lastTimeout))
+        results.wrong++;
+      continue;
+    }
+
+    switch (i % 3) {
+      case 0: {
+        std::vector<uint8_t> request = {LINK_PING, tag};
+        for (uint8_t b = 0; b < pingPayload; b++)
+          request.push_back(i * 7 + b);
+        if (exchange(link, request, reply, results.kinds[0], results) &&
+            !std::equal(request.begin() + 2, request.end(), reply.begin() + 3))
+          results.wrong++;
+        break;
+      }
+      case 1:
+        exchange(link, {LINK_TELEMETRY, tag, 0}, reply, results.kinds[1], results);
+        break;
+      case 2:
+        if (exchange(link, {LINK_GET_SETTINGS, tag}, reply, results.kinds[2], results) &&
+            reply.size() != 4 + 4 * CONFIG_FIELD_COUNT)
+          results.wrong++;
+        break;
+    }
+  }
+
+  // the link's own counters, and the last change of setting
+  requestKind last = {"", {}, {}};
+  if (exchange(link, {LINK_TELEMETRY, 0, 0}, reply, last, results) && reply.size() >= 25) {
+    results.linkFrames = reply[19] | (reply[20] << 8);
+    results.linkBadFrames = reply[21] | (reply[22] << 8);
+    results.linkOverruns = reply[23] | (reply[24] << 8);
+  }
+  if (exchange(link, {LINK_GET_SETTINGS, 1}, reply, last, results) && reply.size() >= 8)
+    results.settingKept = lastTimeout == 0 || little32(reply, 4) == lastTimeout;
+  hostDone = true;
+}
+
+double percentile(std::vector<double> samples, double fraction) {
+  if (samples.empty())
+    return 0;
+  size_t at = (size_t)(fraction * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + at, samples.end());
+  return samples[at];
+}
+
+bool parseOptions(int argc, char **argv, benchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--requests") == 0 && hasValue)
+      options.requests = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--loop-us") == 0 && hasValue)
+      options.loopMicros = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--realtime") == 0)
+      options.realtime = true;
+    else
+      return false;
+  }
+  return true;
+}
+
+// a pseudo terminal in raw mode; the sketch gets the controlling side, the host the other
+bool openTerminal(int &sketchFd, int &hostFd) {
+  sketchFd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (sketchFd < 0 || grantpt(sketchFd) != 0 || unlockpt(sketchFd) != 0)
+    return false;
+  hostFd = open(ptsname(sketchFd), O_RDWR | O_NOCTTY);
+  if (hostFd < 0)
+    return false;
+  struct termios mode;
+  if (tcgetattr(hostFd, &mode) != 0)
+    return false;
+  cfmakeraw(&mode);
+  return tcsetattr(hostFd, TCSANOW, &mode) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr, "usage: %s [--requests n] [--loop-us us] [--realtime]\n", argv[0]);
+    return 2;
+  }
+  int sketchFd;
+  int hostFd;
+  if (!openTerminal(sketchFd, hostFd)) {
+    perror("pseudo terminal");
+    return 1;
+  }
+  Serial.attach(sketchFd, sketchFd);
+
+  hostResults results;
+  setup();
+  std::thread host(runHost, hostFd, std::cref(options), std::ref(results));
+  hostClock::time_point start = hostClock::now();
+  uint64_t startMicros = nativeHal::now();
+  while (!hostDone) {
+    loop();
+    nativeHal::advance(options.loopMicros);
+    loopPasses++;
+    if (options.realtime) {
+      uint64_t hostMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                                hostClock::now() - start).count();
+      uint64_t ahead = nativeHal::now() - startMicros;
+      if (ahead > hostMicros + 1000)
+        std::this_thread::sleep_for(std::chrono::microseconds(ahead - hostMicros));
+    }
+  }
+  host.join();
+
+  printf("%lu requests over a pseudo terminal, %s virtual time, %lu us per loop pass\n\n",
+         options.requests, options.realtime ? "real" : "free-running", options.loopMicros);
+  printf("%-14s %7s %9s %9s %9s %9s %12s %11s\n", "request", "count", "p50 us", "p90 us",
+         "p99 us", "max us", "mean passes", "max passes");
+  for (requestKind &kind : results.kinds) {
+    double meanPasses = 0;
+    uint64_t maxPasses = 0;
+    for (uint64_t p : kind.passes) {
+      meanPasses += p;
+      maxPasses = std::max(maxPasses, p);
+    }
+    if (!kind.passes.empty())
+      meanPasses /= kind.passes.size();
+    printf("%-14s %7zu %9.1f %9.1f %9.1f %9.1f %12.2f %11llu\n", kind.name,
+           kind.roundTrips.size(), percentile(kind.roundTrips, 0.5),
+           percentile(kind.roundTrips, 0.9), percentile(kind.roundTrips, 0.99),
+           percentile(kind.roundTrips, 1.0), meanPasses, (unsigned long long)maxPasses);
+  }
+  printf("\nlink: %u frames received, %u bad, %u overruns\n", results.linkFrames,
+         results.linkBadFrames, results.linkOverruns);
+  printf("replies missing %lu, wrong %lu, last setting %s\n", results.missing, results.wrong,
+         results.settingKept ? "kept" : "LOST");
+  return results.missing == 0 && results.wrong == 0 && results.settingKept ? 0 : 1;
+}
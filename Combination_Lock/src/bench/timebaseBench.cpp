@@ -0,0 +1,300 @@
+/*
+  timebaseBench.cpp
+
+  Wrap-around check of the button library's timebase (buttonTime.h), run on the host with the
+  native core. Build it once per timebase: pio run -e bench_timebase for millis(), and
+  bench_timebase_ticks and bench_timebase_micros for the 16-bit tick and micros(). The virtual
+  clock is started just short of the point where the timebase wraps, or some number of wraps
+  further on, and a button polled or in interrupt mode is pressed, held and released through it
+  with contact bounce on both edges. Each case checks that:
+
+  - the press and the release are each reported once, no sooner than the debounce time after the
+    contacts settled and no later than one unit of the timebase and two loop() passes after that
+  - bounce shorter than the debounce time is never reported
+  - press and release events carry the time the contacts settled, in the timebase
+  - the long-press and repeats come one after the other at the right offsets from the press, and
+    none is missed or added while the button is held across the wrap
+
+  Some cases leave the button untouched for longer than a whole wrap of the timebase before the
+  press, without calling loop(), which a button whose pin didn't move has to cope with. Every
+  loop() is handed a time sampled once per pass, as a sketch scanning several buttons would.
+
+  Options:
+  --seed <n>           random seed for the cases (default 1)
+  --cases <n>          cases for each mode (default 2000)
+  --loop-us <us>       virtual time between loop() calls (default 100)
+
+  Failed checks are listed and make the program exit with status 1.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#include <Arduino.h>
+#include <button.h>
+#include <buttonEvents.h>
+#include <buttonTime.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint8_t benchPin = 9;  // pull-down, so pressed reads HIGH
+const unsigned long debounceTimes[] = {300, 1000, 2500, 10000, 20000, 50000};  // us
+const unsigned long printedFailures = 10;
+
+// the timebase wraps after this many microseconds
+const uint64_t unitMicros = buttonTimeUnitMicros;
+const uint64_t wrapMicros = ((uint64_t)1 << (8 * sizeof(buttonTime_t))) * unitMicros;
+
+struct benchOptions {
+  unsigned long seed = 1;
+  unsigned long cases = 2000;
+  unsigned long loopMicros = 100;
+};
+
+enum failureKind { PRESS_COUNT,
+                   RELEASE_COUNT,
+                   EARLY,
+                   LATE,
+                   EVENT_TIME,
+                   HOLD_EVENTS,
+                   FAILURE_KIND_COUNT };
+
+const char *const failureNames[FAILURE_KIND_COUNT] = {"press count", "release count", "early",
+                                                      "late", "event time", "hold events"};
+
+struct tally {
+  unsigned long cases = 0;
+  unsigned long wraps = 0;  // cases where the timebase wrapped between the press and the release
+  unsigned long failures[FAILURE_KIND_COUNT] = {};
+  unsigned long printed = 0;
+};
+
+// a burst of bounce ending on a level, returns when the contacts settled; pulses are long enough
+// for every pass of loop() to see them and too short to pass for a level of their own
+uint64_t scheduleBounce(std::mt19937 &rng, uint64_t start, uint8_t settleLevel, int64_t shortest,
+                        int64_t longest) {
+  uint64_t time = start;
+  if (longest >= shortest) {
+    std::uniform_int_distribution<int> pairs(0, 3);
+    std::uniform_int_distribution<int64_t> pulse(shortest, longest);
+    for (int i = 2 * pairs(rng); i > 0; i--) {
+      nativeHal::schedulePin(benchPin, time, i % 2 == 0 ? settleLevel : !settleLevel);
+      time += pulse(rng);
+    }
+  }
+  nativeHal::schedulePin(benchPin, time, settleLevel);
+  return time;
+}
+
+// long-presses and repeats due after a hold of the given units
+int64_t holdEventsDue(int64_t held, uint16_t longPress, uint16_t repeat) {
+  if (held < longPress)
+    return 0;
+  return 1 + (held - longPress) / repeat;
+}
+
+void fail(tally &t, failureKind kind, const char *mode, uint64_t start, const char *detail) {
+  t.failures[kind]++;
+  if (t.printed++ < printedFailures)
+    printf("  %s, clock from %llu us: %s, %s\n", mode, (unsigned long long)start,
+           failureNames[kind], detail);
+}
+
+// a detection time against the time the contacts settled
+void checkDetections(tally &t, const char *mode, uint64_t start, failureKind countKind,
+                     const std::vector<uint64_t> &detections, uint64_t settled,
+                     uint64_t debounceMicros, uint64_t loopMicros) {
+  char detail[96];
+  if (detections.size() != 1) {
+    snprintf(detail, sizeof(detail), "%zu reported", detections.size());
+    fail(t, countKind, mode, start, detail);
+    return;
+  }
+  int64_t after = (int64_t)(detections[0] - settled);
+  snprintf(detail, sizeof(detail), "reported %lld us after settling, debounce %llu us",
+           (long long)after, (unsigned long long)debounceMicros);
+  if (after + (int64_t)unitMicros <= (int64_t)debounceMicros)
+    fail(t, EARLY, mode, start, detail);
+  else if (after > (int64_t)(debounceMicros + unitMicros + 2 * loopMicros))
+    fail(t, LATE, mode, start, detail);
+}
+
+// the absolute unit an event time stands for, given the unit it should be close to
+int64_t eventUnits(unsigned long time, uint64_t expectedUnits) {
+  buttonTime_t ahead = (buttonTime_t)time - (buttonTime_t)expectedUnits;
+  buttonTime_t behind = (buttonTime_t)expectedUnits - (buttonTime_t)time;
+  return ahead <= behind ? (int64_t)expectedUnits + ahead : (int64_t)expectedUnits - behind;
+}
+
+bool eventTimeOk(unsigned long time, uint64_t settled, bool interrupts, uint64_t loopMicros) {
+  int64_t units = eventUnits(time, settled / unitMicros);
+  int64_t earliest = settled / unitMicros;
+  int64_t latest = (settled + (interrupts ? 0 : loopMicros)) / unitMicros;
+  return units >= earliest && units <= latest;
+}
+
+void runCase(std::mt19937 &rng, const benchOptions &options, bool interrupts, tally &t) {
+  const char *mode = interrupts ? "interrupts" : "polling";
+  const uint64_t loopMicros = options.loopMicros;
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+  // start short of a wrap, sometimes many wraps in
+  std::uniform_int_distribution<uint64_t> wraps(1, wrapMicros < 1000000000ULL ? 1000 : 2);
+  std::uniform_int_distribution<uint64_t> lead(0, 4000000);
+  uint64_t start = wraps(rng) * wrapMicros - lead(rng);
+  nativeHal::reset(start);
+
+  button b(benchPin, INPUT, false);
+  buttonEventBuffer<8> events;
+  if (interrupts)
+    b.enableInterrupts();
+  b.attachEvents(events);
+
+  const size_t debounceCount = sizeof(debounceTimes) / sizeof(debounceTimes[0]);
+  std::uniform_int_distribution<size_t> pick(0, debounceCount - 1);
+  unsigned long requested = debounceTimes[pick(rng)];
+  b.setDebounceMicros(requested);
+  uint64_t debounceMicros = buttonTimeFromMicros(requested) * unitMicros;
+  uint16_t longPress = buttonTimeFromMillis(300);
+  uint16_t repeat = longPress / 3;
+  events.setLongPressTime(longPress);
+  events.setRepeatInterval(repeat);
+
+  // the press, held for longer than it takes to report it, and the release
+  int64_t longestPulse = (int64_t)debounceMicros - (int64_t)unitMicros - 3 * (int64_t)loopMicros;
+  std::uniform_int_distribution<uint64_t> idle(1000, 2000000);
+  bool longIdle = chance(rng) < 0.1;
+  uint64_t pressStart = nativeHal::now() + idle(rng) + (longIdle ? wrapMicros : 0);
+  uint64_t pressed = scheduleBounce(rng, pressStart, HIGH, loopMicros, longestPulse);
+  std::uniform_int_distribution<uint64_t> hold(debounceMicros + 2 * unitMicros + 5 * loopMicros,
+                                               3000000);
+  uint64_t releaseStart = pressed + hold(rng);
+  uint64_t released = scheduleBounce(rng, releaseStart, LOW, loopMicros, longestPulse);
+  uint64_t end = released + debounceMicros + 2 * unitMicros + 10 * loopMicros;
+
+  std::vector<uint64_t> presses;
+  std::vector<uint64_t> releases;
+  std::vector<buttonEvent> queued;
+  while (nativeHal::now() < end) {
+    // an untouched button is left alone for longer than a wrap
+    if (longIdle && nativeHal::now() + 100000 < pressStart)
+      nativeHal::advance(pressStart - 100000 - nativeHal::now());
+    nativeHal::advance(loopMicros);
+    buttonTime_t now = buttonNow();
+    b.loop(now);
+    if (b.isPressed())
+      presses.push_back(nativeHal::now());
+    if (b.isReleased())
+      releases.push_back(nativeHal::now());
+    buttonEvent event;
+    while (events.pop(event))
+      queued.push_back(event);
+  }
+  b.disableInterrupts();
+
+  t.cases++;
+  if (longIdle || pressed / wrapMicros != releaseStart / wrapMicros)
+    t.wraps++;
+
+  checkDetections(t, mode, start, PRESS_COUNT, presses, pressed, debounceMicros, loopMicros);
+  checkDetections(t, mode, start, RELEASE_COUNT, releases, released, debounceMicros, loopMicros);
+  if (presses.size() != 1 || releases.size() != 1)
+    return;
+
+  // a press, the long-press and repeats at their offsets from it, then the release
+  char detail[96];
+  if (queued.size() < 2 || queued.front().type != BUTTON_PRESS ||
+      queued.back().type != BUTTON_RELEASE) {
+    snprintf(detail, sizeof(detail), "%zu events without a press and a release", queued.size());
+    fail(t, HOLD_EVENTS, mode, start, detail);
+    return;
+  }
+  if (!eventTimeOk(queued.front().time, pressed, interrupts, loopMicros) ||
+      !eventTimeOk(queued.back().time, released, interrupts, loopMicros)) {
+    snprintf(detail, sizeof(detail), "press at %lu, release at %lu", queued.front().time,
+             queued.back().time);
+    fail(t, EVENT_TIME, mode, start, detail);
+    return;
+  }
+
+  int64_t pressUnits = eventUnits(queued.front().time, pressed / unitMicros);
+  int64_t holdEvents = queued.size() - 2;
+  for (int64_t i = 0; i < holdEvents; i++) {
+    const buttonEvent &event = queued[1 + i];
+    buttonTime_t offset = (buttonTime_t)event.time - (buttonTime_t)queued.front().time;
+    if (event.type != (i == 0 ? BUTTON_LONG_PRESS : BUTTON_REPEAT) ||
+        offset != longPress + i * repeat) {
+      snprintf(detail, sizeof(detail), "hold event %lld of type %u at +%lu units", (long long)i,
+               event.type, (unsigned long)offset);
+      fail(t, HOLD_EVENTS, mode, start, detail);
+      return;
+    }
+  }
+  // all that came due before the release started, and none after it was reported
+  int64_t fewest = holdEventsDue((releaseStart - loopMicros) / unitMicros - pressUnits - 1,
+                                 longPress, repeat);
+  int64_t most = holdEventsDue(releases[0] / unitMicros - pressUnits, longPress, repeat);
+  if (holdEvents < fewest || holdEvents > most) {
+    snprintf(detail, sizeof(detail), "%lld long-press and repeats, expected %lld to %lld",
+             (long long)holdEvents, (long long)fewest, (long long)most);
+    fail(t, HOLD_EVENTS, mode, start, detail);
+  }
+}
+
+bool parseOptions(int argc, char **argv, benchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--seed") == 0 && hasValue)
+      options.seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--cases") == 0 && hasValue)
+      options.cases = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--loop-us") == 0 && hasValue)
+      options.loopMicros = strtoul(argv[++i], NULL, 10);
+    else
+      return false;
+  }
+  return options.loopMicros > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  benchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr, "usage: %s [--seed n] [--cases n] [--loop-us us]\n", argv[0]);
+    return 2;
+  }
+
+  const char *name = BUTTON_TIMEBASE == BUTTON_TIMEBASE_TICKS    ? "16-bit tick"
+                     : BUTTON_TIMEBASE == BUTTON_TIMEBASE_MICROS ? "micros()"
+                                                                 : "millis()";
+  printf("timebase %s, %lu us per unit, wraps every %.3f s, seed %lu, loop every %lu us\n\n", name,
+         buttonTimeUnitMicros, wrapMicros / 1e6, options.seed, options.loopMicros);
+
+  std::mt19937 rng(options.seed);
+  unsigned long failures = 0;
+  for (int interrupts = 0; interrupts < 2; interrupts++) {
+    tally t;
+    for (unsigned long i = 0; i < options.cases; i++)
+      runCase(rng, options, interrupts, t);
+    printf("%-10s %lu cases, %lu across a wrap\n", interrupts ? "interrupts" : "polling", t.cases,
+           t.wraps);
+    for (uint8_t kind = 0; kind < FAILURE_KIND_COUNT; kind++) {
+      if (t.failures[kind] > 0)
+        printf("  %-14s %lu\n", failureNames[kind], t.failures[kind]);
+      failures += t.failures[kind];
+    }
+  }
+  printf("\n%lu failed checks\n", failures);
+  return failures == 0 ? 0 : 1;
+}
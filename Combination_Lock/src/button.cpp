@@ -5,6 +5,7 @@ button::button() : button(NOT_A_PIN){};  // useful when preallocating space in a
 button::button(int pin) : button(pin, INPUT_PULLUP, true){};
 
 button::button(int pin, int mode, bool pullUpResistor) {
+  buttonTimeBegin();
   buttonPin = pin;
   pinMode(buttonPin, mode);
   buttonPullUpResistor = pullUpResistor;
@@ -18,10 +19,20 @@ button::button(int pin, int mode, bool pullUpResistor) {
   lastFlickerableState = previousSteadyState;
 
   lastDebounceTime = 0;
+
+  edgeBuffer = NULL;
+
+  events = NULL;
+  eventId = 0;
+  holdEvents = 0;
 }
 
 void button::setDebounceTime(unsigned long time) {
-  debounceTime = time;
+  debounceTime = buttonTimeFromMillis(time);  // a debounce time over 0xFFFF units is saturated
+}
+
+void button::setDebounceMicros(unsigned long time) {
+  debounceTime = buttonTimeFromMicros(time);
 }
 
 int button::getState(void) {
@@ -86,10 +97,52 @@ void button::resetCount(void) {
   count = 0;
 }
 
+bool button::enableInterrupts(void) {
+  edgeBuffer = attachPinChange(buttonPin);
+  return edgeBuffer != NULL;
+}
+
+void button::disableInterrupts(void) {
+  if (edgeBuffer != NULL) {
+    detachPinChange(buttonPin);
+    edgeBuffer = NULL;
+  }
+}
+
+// in interrupt mode with nothing queued and nothing left to debounce, report or time
+bool button::isIdle(void) {
+  if (events != NULL && events->holdEventsEnabled() && isHeld())
+    return false;
+  return edgeBuffer != NULL && edgeBuffer->empty() && lastFlickerableState == lastSteadyState &&
+         previousSteadyState == lastSteadyState;
+}
+
+void button::attachEvents(buttonEventQueue &queue, uint8_t id) {
+  events = &queue;
+  eventId = id;
+  holdEvents = 0;
+}
+
+void button::detachEvents(void) {
+  events = NULL;
+}
+
+bool button::isHeld(void) {
+  return lastSteadyState == (buttonPullUpResistor ? LOW : HIGH);
+}
+
 void button::loop(void) {
+  loop(buttonNow());
+}
+
+void button::loop(buttonTime_t currentTime) {
+  if (edgeBuffer != NULL) {
+    loopInterrupts(currentTime);
+    return;
+  }
+
   // read the state of the switch/button:
-  int currentState = digitalRead(buttonPin);
-  unsigned long currentTime = millis();
+  uint8_t currentState = digitalRead(buttonPin);
 
   // check to see if you just pressed the button
   // (i.e. the input went from LOW to HIGH), and you've waited long enough
@@ -103,38 +156,94 @@ void button::loop(void) {
     lastFlickerableState = currentState;
   }
 
-  if ((currentTime - lastDebounceTime) >= debounceTime) {
+  // a steady state change is only reported for the loop it happened in, even when the debounce
+  // timer restarts right after it
+  previousSteadyState = lastSteadyState;
+  if ((buttonTime_t)(currentTime - lastDebounceTime) >= debounceTime) {
     // whatever the reading is at, it's been there for longer than the debounce
     // delay, so take it as the actual current state:
 
     // save the the steady state
-    previousSteadyState = lastSteadyState;
     lastSteadyState = currentState;
   }
 
-  if (previousSteadyState != lastSteadyState) {
-    if (countMode == COUNT_BOTH)
-      count++;
-    else if (countMode == COUNT_PRESSES) {
-      if (buttonPullUpResistor) {
-        if (isPressed_pullUp())
-          count++;
-      } else {
-        if (isPressed_pullDown())
-          count++;
-      }
-    } else if (countMode == COUNT_RELEASES) {
-      if (buttonPullUpResistor) {
-        if (isReleased_pullUp())
-          count++;
-      } else {
-        if (isReleased_pullDown())
-          count++;
-      }
+  if (previousSteadyState != lastSteadyState)
+    countEdge();
+  queueHoldEvents(currentTime);
+}
+
+// take the flickerable state as steady once it has been held for the debounce time
+void button::settle(buttonTime_t currentTime) {
+  if ((buttonTime_t)(currentTime - lastDebounceTime) >= debounceTime &&
+      lastFlickerableState != lastSteadyState) {
+    previousSteadyState = lastSteadyState;
+    lastSteadyState = lastFlickerableState;
+    countEdge();
+  }
+}
+
+// debounce queued edges at the time they were captured rather than the time they are read
+void button::loopInterrupts(buttonTime_t currentTime) {
+  // a steady state change is only reported for the loop it happened in
+  previousSteadyState = lastSteadyState;
+
+  pinEdge edge;
+  while (edgeBuffer->pop(edge)) {
+    // the previous level may have been held long enough to count before this edge replaced it
+    settle(edge.time);
+    queueHoldEvents(edge.time);
+    lastFlickerableState = edge.level;
+    lastDebounceTime = edge.time;
+  }
+
+  // edges were dropped, restart debouncing from what the pin reads now
+  if (edgeBuffer->overflowed()) {
+    lastFlickerableState = digitalRead(buttonPin);
+    lastDebounceTime = currentTime;
+  }
+
+  settle(currentTime);
+  queueHoldEvents(currentTime);
+}
+
+void button::countEdge(void) {
+  // the steady state changed, lastDebounceTime is when the new level started
+  if (events != NULL) {
+    events->push(lastDebounceTime, isHeld() ? BUTTON_PRESS : BUTTON_RELEASE, eventId);
+    holdEvents = 0;
+  }
+
+  if (countMode == COUNT_BOTH)
+    count++;
+  else if (countMode == COUNT_PRESSES) {
+    if (buttonPullUpResistor) {
+      if (isPressed_pullUp())
+        count++;
+    } else {
+      if (isPressed_pullDown())
+        count++;
+    }
+  } else if (countMode == COUNT_RELEASES) {
+    if (buttonPullUpResistor) {
+      if (isReleased_pullUp())
+        count++;
+    } else {
+      if (isReleased_pullDown())
+        count++;
     }
   }
 }
 
+// long-presses and repeats come due while the button is held, timed from the start of the press
+void button::queueHoldEvents(buttonTime_t currentTime) {
+  if (events != NULL && isHeld()) {
+    // the hold time is taken in the timebase so a 16-bit tick that wrapped still counts forward
+    buttonTime_t held = currentTime - lastDebounceTime;
+    events->pushHoldEvents(eventId, lastDebounceTime, (unsigned long)lastDebounceTime + held,
+                           holdEvents);
+  }
+}
+
 /*
  * Copyright (c) 2019, ArduinoGetStarted.com. All rights reserved.
  *
@@ -9,6 +9,9 @@
   - change count behavior from tracking rising and falling events to presses and releases for
     easier comprehension of events with separate logic for pull-up and pull-down resistors
   - Doxygen documentation added
+  - optional interrupt driven edge capture so presses aren't lost while loop() is blocked
+  - optional queue of timestamped press, release, long-press and repeat events
+  - selectable timebase, a 16-bit tick or micros() instead of millis(), sampled once per scan
 
   The ezButton documentation is a great place to start to see example use cases of the library:
   https://arduinogetstarted.com/tutorials/arduino-button-library
@@ -30,6 +33,33 @@
   in either the pull-up or pull-down configuration and the third parameter cements this button as a
   pull-down button.
 
+  button1.enableInterrupts();
+  Any of the buttons above can switch from polling to interrupt capture after construction. Pin
+  changes are then timestamped by a pin change interrupt and queued (see pinChange.h), and loop()
+  debounces the queued edges at the times they happened instead of the time loop() gets around to
+  reading the pin. If loop() was blocked for a while, several presses may be debounced in one call;
+  getCount() includes all of them while isPressed() and isReleased() report the last one.
+  Once isIdle() is true, nothing more can happen until the pin changes, so the MCU may sleep until
+  the pin change interrupt wakes it (see powerDown.h).
+
+  button1.attachEvents(queue, id);
+  Instead of asking isPressed() on every loop, a sketch can have the button record its presses,
+  releases, long-presses and repeats into a queue and drain it whenever it has time, so no edge is
+  lost when a loop() pass is missed (see buttonEvents.h). Event times are those at which the
+  debounced level started, which in interrupt mode are the times the edges were captured.
+
+  button1.loop(now);
+  Debouncing runs in the timebase picked with BUTTON_TIMEBASE (see buttonTime.h), millis() by
+  default. loop() reads buttonNow() itself; a sketch scanning several buttons can read it once and
+  pass the same time to each. setDebounceTime() takes milliseconds and setDebounceMicros()
+  microseconds, both rounded up to whole units of the timebase and saturated at 0xFFFF units, so
+  the micros() timebase debounces for at most 65 ms. Event times and the long-press and repeat
+  times of buttonEvents.h are in units of the timebase too; with the 16-bit tick only the low 16
+  bits of an event time count.
+
+  For buttons whose configuration never changes, fastButton.h provides a header-only template
+  variant that fixes the pin, mode, resistor, count mode and debounce time at compile time.
+
   modified 27 Nov 2022
   by Beaker406
 
@@ -44,24 +74,38 @@
 #define button_h
 
 #include <Arduino.h>
+#include <buttonEvents.h>
+#include <buttonTime.h>
+#include <pinChange.h>
+
 enum countModes { COUNT_PRESSES,
                   COUNT_RELEASES,
                   COUNT_BOTH };
 
 class button {
  private:
-  int buttonPin;               // the pin the button is connected to
-  unsigned long debounceTime;  // longer times decrease false positives but increase button hold time
-  unsigned long count;         // number of events determined by countMode
-  int countMode;               // count presses, releases, or both
-  bool buttonPullUpResistor;   // is a pull-up resistor in use?
+  uint8_t buttonPin;          // the pin the button is connected to
+  uint16_t debounceTime;      // longer times decrease false positives but increase button hold time
+  unsigned long count;        // number of events determined by countMode
+  uint8_t countMode;          // count presses, releases, or both
+  bool buttonPullUpResistor;  // is a pull-up resistor in use?
+
+  uint8_t previousSteadyState;   // the previous steady state from the input pin, used to detect pressed and released events
+  uint8_t lastSteadyState;       // the last steady state from the input pin
+  uint8_t lastFlickerableState;  // the last flickerable state from the input pin
+
+  buttonTime_t lastDebounceTime;  // the last time the output pin was toggled
 
-  int previousSteadyState;   // the previous steady state from the input pin, used to detect pressed and released events
-  int lastSteadyState;       // the last steady state from the input pin
-  int lastFlickerableState;  // the last flickerable state from the input pin
+  pinEdgeBuffer *edgeBuffer;  // queued edges in interrupt mode, NULL while polling
 
-  unsigned long lastDebounceTime;  // the last time the output pin was toggled
+  buttonEventQueue *events;  // where events are recorded, NULL when they aren't
+  uint8_t eventId;           // the button field of recorded events
+  uint16_t holdEvents;       // long-press and repeat events recorded since the last press
 
+  void countEdge(void);
+  void queueHoldEvents(buttonTime_t currentTime);
+  void settle(buttonTime_t currentTime);
+  void loopInterrupts(buttonTime_t currentTime);
   bool isPressed_pullUp(void);
   bool isPressed_pullDown(void);
   bool isReleased_pullUp(void);
@@ -72,14 +116,22 @@ class button {
   button(int pin);
   button(int pin, int mode, bool pullUpResistor);
   void setDebounceTime(unsigned long time);
+  void setDebounceMicros(unsigned long time);
   int getState(void);
   int getStateRaw(void);
   bool isPressed(void);
   bool isReleased(void);
+  bool isHeld(void);  // the debounced state is pressed
   void setCountMode(int mode);
   unsigned long getCount(void);
   void resetCount(void);
+  bool enableInterrupts(void);
+  void disableInterrupts(void);
+  bool isIdle(void);
+  void attachEvents(buttonEventQueue &queue, uint8_t id = 0);
+  void detachEvents(void);
   void loop(void);
+  void loop(buttonTime_t currentTime);  // with the time sampled once for the whole scan
 };
 
 #endif
@@ -0,0 +1,76 @@
+#include <buttonEvents.h>
+
+buttonEventQueue::buttonEventQueue(buttonEvent *slots, uint8_t capacity)
+    : slots(slots), capacity(capacity), first(0), length(0), dropped(false), longPressTime(0),
+      repeatInterval(0) {}
+
+bool buttonEventQueue::push(unsigned long time, uint8_t type, uint8_t button) {
+  if (length == capacity) {
+    dropped = true;
+    return false;
+  }
+  uint8_t slot = first + length;
+  if (slot >= capacity)
+    slot -= capacity;
+  slots[slot].time = time;
+  slots[slot].type = type;
+  slots[slot].button = button;
+  length++;
+  return true;
+}
+
+bool buttonEventQueue::pop(buttonEvent &event) {
+  if (!peek(event))
+    return false;
+  first = first + 1 == capacity ? 0 : first + 1;
+  length--;
+  return true;
+}
+
+bool buttonEventQueue::peek(buttonEvent &event) const {
+  if (length == 0)
+    return false;
+  event = slots[first];
+  return true;
+}
+
+void buttonEventQueue::clear(void) {
+  first = 0;
+  length = 0;
+  dropped = false;
+}
+
+bool buttonEventQueue::overflowed(void) {
+  if (!dropped)
+    return false;
+  dropped = false;
+  return true;
+}
+
+void buttonEventQueue::pushHoldEvents(uint8_t button, unsigned long heldSince, unsigned long now,
+                                      uint16_t &emitted) {
+  if (longPressTime == 0)
+    return;
+  unsigned long held = now - heldSince;
+  if (held < longPressTime)
+    return;
+
+  // hold events due so far: the long-press, then one per repeat interval after it
+  unsigned long due = 1;
+  if (repeatInterval != 0)
+    due += (held - longPressTime) / repeatInterval;
+  if (due > 0xFFFF)
+    due = 0xFFFF;
+  if (due <= emitted)
+    return;
+
+  if (emitted == 0 && !push(heldSince + longPressTime, BUTTON_LONG_PRESS, button))
+    return;
+  // only the latest of any repeats that came due since the last call
+  if (due > 1 &&
+      !push(heldSince + longPressTime + (due - 1) * repeatInterval, BUTTON_REPEAT, button)) {
+    emitted = 1;
+    return;
+  }
+  emitted = due;
+}
@@ -0,0 +1,106 @@
+/*
+  buttonEvents.h
+
+  Timestamped button events. isPressed() and isReleased() only hold for the single loop() call in
+  which the debounced state changed, so a sketch that misses that call misses the edge. Buttons and
+  groups can instead record press, release, long-press and repeat events into a fixed-size queue
+  that the sketch drains whenever it gets around to it:
+
+  buttonEventBuffer<8> events;  // room for eight events
+  button1.attachEvents(events, 1);
+  events.setLongPressTime(800);    // a long-press after 800 ms held, 0 to turn off
+  events.setRepeatInterval(200);   // then a repeat every 200 ms, 0 to turn off
+
+  buttonEvent event;
+  while (events.pop(event)) {
+    if (event.type == BUTTON_PRESS && event.button == 1)
+      ...
+  }
+
+  Press and release events carry the time the debounced level started, which is the time the pin
+  last changed rather than the time the debounce period ran out. For a button in interrupt mode
+  that is the time the pin change interrupt saw the edge, so events stay accurate and in order
+  however late loop() runs. A long-press comes one long-press time after the press and repeats
+  follow every repeat interval while the button stays held. When loop() falls behind by more than
+  one interval, the missed repeats are skipped and a single repeat is queued for the latest one.
+
+  Any number of buttons and groups can share a queue, each under its own id, so a sketch can drain
+  all of its input in order of arrival. Events that don't fit are dropped, which overflowed()
+  reports once. Times are in the button's timebase, millis() unless noted otherwise; for a button
+  that is BUTTON_TIMEBASE (buttonTime.h), which the long-press and repeat times are counted in too.
+
+  buttonGroup.h provides buttonGroupEvents to record the events of a group.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef buttonEvents_h
+#define buttonEvents_h
+
+#include <Arduino.h>
+
+enum buttonEventType { BUTTON_PRESS,
+                       BUTTON_RELEASE,
+                       BUTTON_LONG_PRESS,
+                       BUTTON_REPEAT };
+
+struct buttonEvent {
+  unsigned long time;  // when the event happened
+  uint8_t type;        // a buttonEventType
+  uint8_t button;      // id the button was attached with, or the index of a button in a group
+};
+
+// the storage comes from buttonEventBuffer, so buttons can point at queues of any capacity
+class buttonEventQueue {
+ public:
+  bool pop(buttonEvent &event);
+  bool peek(buttonEvent &event) const;
+  bool empty(void) const { return length == 0; }
+  uint8_t size(void) const { return length; }
+  void clear(void);
+
+  // true once after events were dropped because the queue was full
+  bool overflowed(void);
+
+  // long-press and repeat times apply to every button recording into this queue
+  void setLongPressTime(uint16_t time) { longPressTime = time; }
+  void setRepeatInterval(uint16_t interval) { repeatInterval = interval; }
+  bool holdEventsEnabled(void) const { return longPressTime != 0; }
+
+  // producer side, used by buttons and groups
+  bool push(unsigned long time, uint8_t type, uint8_t button);
+
+  // queue the long-press and repeat events due by now for a button held since heldSince, emitted
+  // counts the hold events already queued for this hold and must start at zero with each press
+  void pushHoldEvents(uint8_t button, unsigned long heldSince, unsigned long now, uint16_t &emitted);
+
+ protected:
+  buttonEventQueue(buttonEvent *slots, uint8_t capacity);
+
+ private:
+  buttonEvent *slots;
+  uint8_t capacity;
+  uint8_t first;   // slot of the oldest event
+  uint8_t length;  // events queued
+  bool dropped;
+  uint16_t longPressTime;
+  uint16_t repeatInterval;
+};
+
+template <uint8_t Capacity>
+class buttonEventBuffer : public buttonEventQueue {
+  static_assert(Capacity > 0, "an event queue needs room for at least one event");
+
+ public:
+  buttonEventBuffer() : buttonEventQueue(storage, Capacity) {}
+
+ private:
+  buttonEvent storage[Capacity];
+};
+
+#endif
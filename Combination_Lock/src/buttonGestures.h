@@ -0,0 +1,234 @@
+/*
+  buttonGestures.h
+
+  A gesture layer on top of the button library that turns the debounced state of up to 8 keys into
+  clicks, multi-clicks, long-presses and chords. It runs as a small state machine fed once per scan
+  with the set of keys held, so each scan costs the same however many keys there are, and it keeps
+  all gesture timing in one place instead of in every sketch.
+
+  buttonGestures<3> gestures;
+  gestures.setLongPressTime(600);   // hold this long for a long-press, 0 to turn off
+  gestures.setMultiClickTime(250);  // wait this long for another click, 0 to report every click
+
+  buttons.loop();
+  gestures.update(buttons, millis());  // a buttonGroup, or an array of buttons
+  gesture g;
+  while (gestures.read(g)) {
+    if (g.type == GESTURE_CLICK && g.clicks == 2)
+      ...  // double-click of the keys in g.keys
+  }
+
+  A gesture starts when any key goes down and takes in every key held before all of them are let
+  go again, so keys pressed together form a chord and keys must be released between gestures. A
+  chord is reported like a single key, as the set of keys it used. chordSymbol() numbers the 2^N - 1
+  possible sets so they can be used as combo symbols: single keys keep their own index, followed by
+  every pair, every triple and so on. Three keys thus give seven symbols: 0 to 2 for the single
+  keys, 3 for keys 0 and 1, 4 for 0 and 2, 5 for 1 and 2, and 6 for all three.
+
+  - GESTURE_CLICK........The keys were pressed and released, clicks times in a row within the
+                         multi-click time of each other. Without a multi-click time every click is
+                         reported on release; with one, the clicks are reported once the time has
+                         passed without another click of the same keys, or as soon as other keys are
+                         clicked.
+  - GESTURE_LONG_PRESS...The keys have been held for the long-press time, reported while they are
+                         still held. clicks counts the clicks before it plus the long-press itself.
+                         Releasing the keys afterwards reports nothing.
+
+  Times are those of the first press of the gesture. At most two gestures complete in one update,
+  so read them all after every update; gestures that don't fit are dropped. The timing edges of
+  each gesture are checked by src/bench/gestureBench.cpp (pio run -e bench_gestures).
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef buttonGestures_h
+#define buttonGestures_h
+
+#include <button.h>
+
+enum gestureType { GESTURE_CLICK,
+                   GESTURE_LONG_PRESS };
+
+struct gesture {
+  unsigned long time;  // when the first key of the gesture went down
+  uint8_t type;        // a gestureType
+  uint8_t keys;        // the keys used, bit i for key i
+  uint8_t clicks;      // clicks in a row
+};
+
+template <uint8_t N>
+class buttonGestures {
+  static_assert(N > 0 && N <= 8, "gestures are recognized across 1 to 8 keys");
+
+ public:
+  // number of distinct chords, and so of chord symbols
+  static const uint8_t symbols = (uint8_t)((1 << N) - 1);
+
+  buttonGestures() : longPressTime(0), multiClickTime(0) { reset(); }
+
+  void setLongPressTime(uint16_t time) { longPressTime = time; }
+  void setMultiClickTime(uint16_t time) { multiClickTime = time; }
+
+  // forget any gesture in progress and any not yet read
+  void reset(void) {
+    state = IDLE;
+    downKeys = 0;
+    pendingKeys = 0;
+    pendingClicks = 0;
+    waiting = 0;
+  }
+
+  // feed the keys held in this scan, bit i set while key i is pressed
+  void update(uint8_t held, unsigned long currentTime) {
+    held &= symbols;
+    switch (state) {
+      case IDLE:
+      case RELEASED:
+        if (state == RELEASED && currentTime - releasedAt >= multiClickTime) {
+          flushPending();
+          state = IDLE;
+        }
+        if (held) {
+          state = DOWN;
+          downKeys = held;
+          downSince = currentTime;
+        }
+        break;
+
+      case DOWN:
+        downKeys |= held;
+        if (!held) {
+          if (!(pendingClicks > 0 && downKeys == pendingKeys && pendingClicks < 0xFF)) {
+            flushPending();
+            pendingKeys = downKeys;
+            pendingSince = downSince;
+          }
+          pendingClicks++;
+          if (multiClickTime == 0) {
+            flushPending();
+            state = IDLE;
+          } else {
+            releasedAt = currentTime;
+            state = RELEASED;
+          }
+        } else if (longPressTime != 0 && currentTime - downSince >= longPressTime) {
+          uint8_t clicks = 1;
+          unsigned long since = downSince;
+          if (pendingClicks > 0 && downKeys == pendingKeys) {
+            clicks += pendingClicks;
+            since = pendingSince;
+            pendingClicks = 0;
+          }
+          flushPending();
+          emit(GESTURE_LONG_PRESS, downKeys, clicks, since);
+          state = LONG_HELD;
+        }
+        break;
+
+      case LONG_HELD:
+        if (!held)
+          state = IDLE;
+        break;
+    }
+  }
+
+  // a group's held keys, buttonGroup or verticalButtonGroup
+  template <class Group>
+  void update(const Group &group, unsigned long currentTime) {
+    update((uint8_t)group.heldMask(), currentTime);
+  }
+
+  // an array of N buttons that have already been scanned
+  void update(button buttons[], unsigned long currentTime) {
+    uint8_t held = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      if (buttons[i].isHeld())
+        held |= 1 << i;
+    }
+    update(held, currentTime);
+  }
+
+  // take the oldest completed gesture, false when there is none
+  bool read(gesture &g) {
+    if (waiting == 0)
+      return false;
+    g = completed[0];
+    completed[0] = completed[1];
+    waiting--;
+    return true;
+  }
+
+  // number a set of keys: single keys first, then pairs, triples and so on, each in key order
+  static uint8_t chordSymbol(uint8_t keys) {
+    keys &= symbols;
+    uint8_t size = 0;
+    for (uint8_t k = keys; k; k &= k - 1)
+      size++;
+    if (size == 0)
+      return 0;
+
+    // all smaller chords come first, then this chord's rank among chords of its size
+    uint8_t symbol = 0;
+    for (uint8_t s = 1; s < size; s++)
+      symbol += choose(N, s);
+    uint8_t nth = 0;
+    for (uint8_t key = 0; key < N; key++) {
+      if (keys & (1 << key))
+        symbol += choose(key, ++nth);
+    }
+    return symbol;
+  }
+
+ private:
+  enum gestureState { IDLE,       // nothing held, no clicks waiting
+                      DOWN,       // keys held
+                      RELEASED,   // released, waiting for another click
+                      LONG_HELD };  // long-press reported, waiting for release
+
+  uint16_t longPressTime;
+  uint16_t multiClickTime;
+
+  uint8_t state;
+  uint8_t downKeys;  // keys held since the current press began
+  unsigned long downSince;
+  unsigned long releasedAt;
+
+  uint8_t pendingKeys;  // clicks not yet reported
+  uint8_t pendingClicks;
+  unsigned long pendingSince;
+
+  gesture completed[2];
+  uint8_t waiting;
+
+  void flushPending(void) {
+    if (pendingClicks > 0)
+      emit(GESTURE_CLICK, pendingKeys, pendingClicks, pendingSince);
+    pendingClicks = 0;
+  }
+
+  void emit(uint8_t type, uint8_t keys, uint8_t clicks, unsigned long time) {
+    if (waiting == 2)
+      return;
+    gesture &g = completed[waiting++];
+    g.time = time;
+    g.type = type;
+    g.keys = keys;
+    g.clicks = clicks;
+  }
+
+  static uint8_t choose(uint8_t n, uint8_t k) {
+    if (k > n)
+      return 0;
+    uint8_t result = 1;
+    for (uint8_t i = 1; i <= k; i++)
+      result = result * (n - k + i) / i;
+    return result;
+  }
+};
+
+#endif
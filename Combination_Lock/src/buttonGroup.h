@@ -0,0 +1,312 @@
+/*
+  buttonGroup.h
+
+  A batched companion to the button library for sketches that watch many buttons at once. Instead
+  of every button calling digitalRead() and millis() on its own, a buttonGroup reads each input
+  port register once per scan, takes a single timestamp, and debounces every button in the group
+  from that one snapshot using bitwise operations. The per-button semantics match the button
+  library: isPressed() and isReleased() are true for the single scan in which a debounced edge
+  occurs, getCount() follows the selected count mode, and getState() reports the pin level.
+
+  Scan cost is one register read per distinct port plus a few shift and mask operations per button.
+  Only buttons whose reading differs from their steady state are visited for a debounce time check,
+  so an idle group costs the same no matter how many of its buttons are waiting.
+
+  To get started, declare the group with the number of buttons as a template parameter:
+
+  const uint8_t pins[] = {9, 10, 11};
+  buttonGroup<3> buttons(pins, INPUT, false);
+
+  Call buttons.loop() once per pass of the sketch loop and query each button by its index in the
+  pins array. Groups are limited to 32 buttons; the bitmask type shrinks to 8 or 16 bits for
+  smaller groups so 8-bit MCUs don't pay for 32-bit operations they don't need. An optional second
+  template parameter narrows the per-button press counters when the full unsigned long range of
+  button::getCount() isn't needed, e.g. buttonGroup<16, uint8_t>.
+
+  buttonGroupEvents records a group's presses, releases, long-presses and repeats into the same
+  kind of event queue single buttons use (see buttonEvents.h).
+
+  The debounce engine is the only difference between group types. buttonGroup keeps one timer per
+  button and applies the same rule as button::loop(); verticalButtonGroup in verticalCounter.h
+  integrates samples with bit-sliced counters instead and needs only two bits per button. How the
+  pins are read is up to the sampler: keypadMatrix in keypadMatrix.h is a buttonGroup that scans a
+  row/column key matrix instead of one pin per button.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef buttonGroup_h
+#define buttonGroup_h
+
+#include <button.h>
+
+// pick the narrowest unsigned type with one bit per button
+template <bool fits8, bool fits16>
+struct buttonMaskSelect { typedef uint32_t type; };
+template <bool fits16>
+struct buttonMaskSelect<true, fits16> { typedef uint8_t type; };
+template <>
+struct buttonMaskSelect<false, true> { typedef uint16_t type; };
+
+template <uint8_t N>
+struct buttonMask : buttonMaskSelect<(N <= 8), (N <= 16)> {
+  static_assert(N > 0 && N <= 32, "a button group holds between 1 and 32 buttons");
+};
+
+// reads the pins of a group into a bitmask, bit i set when pin i reads HIGH
+template <uint8_t N>
+class portSampler {
+ public:
+  typedef typename buttonMask<N>::type mask_t;
+
+  void begin(const uint8_t pins[], uint8_t mode) {
+#ifdef __AVR__
+    portsUsed = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      pinMode(pins[i], mode);
+      uint8_t port = digitalPinToPort(pins[i]);
+      if (port == NOT_A_PIN) {  // never reads HIGH
+        bitMask[i] = 0;
+        portIndex[i] = 0;
+        continue;
+      }
+      bitMask[i] = digitalPinToBitMask(pins[i]);
+
+      volatile uint8_t *reg = portInputRegister(port);
+      uint8_t p = 0;
+      while (p < portsUsed && inputRegister[p] != reg)
+        p++;
+      if (p == portsUsed)
+        inputRegister[portsUsed++] = reg;
+      portIndex[i] = p;
+    }
+#else
+    for (uint8_t i = 0; i < N; i++) {
+      pin[i] = pins[i];
+      pinMode(pin[i], mode);
+    }
+#endif
+  }
+
+  mask_t read(void) const {
+    mask_t raw = 0;
+    mask_t bit = 1;
+#ifdef __AVR__
+    // one read per port, then pick each button's bit out of the snapshot
+    uint8_t snapshot[portSlots] = {};
+    for (uint8_t p = 0; p < portsUsed; p++)
+      snapshot[p] = *inputRegister[p];
+    for (uint8_t i = 0; i < N; i++, bit <<= 1) {
+      if (snapshot[portIndex[i]] & bitMask[i])
+        raw |= bit;
+    }
+#else
+    for (uint8_t i = 0; i < N; i++, bit <<= 1) {
+      if (digitalRead(pin[i]) == HIGH)
+        raw |= bit;
+    }
+#endif
+    return raw;
+  }
+
+ private:
+#ifdef __AVR__
+  // no group can span more ports than it has buttons, and the largest AVR boards have 11 ports
+  static const uint8_t portSlots = N < 11 ? N : 11;
+  volatile uint8_t *inputRegister[portSlots];
+  uint8_t portsUsed;
+  uint8_t portIndex[N];  // which inputRegister slot each button lives in
+  uint8_t bitMask[N];    // each button's bit within its port
+#else
+  uint8_t pin[N];
+#endif
+};
+
+// state and queries shared by every group debounce engine; engines only decide which bits of the
+// steady state flip on each scan and hand them to commitEdges(). The sampler turns the pins into a
+// bitmask of levels; anything with begin(pins, mode) and read() will do, see keypadMatrix.h.
+template <uint8_t N, typename count_t, class Sampler = portSampler<N> >
+class buttonGroupCore {
+ public:
+  typedef typename buttonMask<N>::type mask_t;
+
+  uint8_t size(void) const { return N; }
+  void setCountMode(uint8_t mode) { countMode = mode; }
+
+  // pin level of the debounced state, HIGH or LOW like button::getState()
+  int getState(uint8_t index) const { return (normalize(steady) & bitOf(index)) ? HIGH : LOW; }
+  bool isPressed(uint8_t index) const { return pressedMask() & bitOf(index); }
+  bool isReleased(uint8_t index) const { return releasedMask() & bitOf(index); }
+  count_t getCount(uint8_t index) const { return count[index]; }
+  void resetCount(uint8_t index) { count[index] = 0; }
+
+  // whole-group views, bit i belongs to button i
+  mask_t heldMask(void) const { return steady; }
+  mask_t pressedMask(void) const { return edges & steady; }
+  mask_t releasedMask(void) const { return edges & ~steady; }
+
+ protected:
+  Sampler sampler;
+  mask_t pressedLevel;  // all ones for pull-down buttons, pressed reads HIGH
+  mask_t steady;        // the debounced state, pressed bits set
+  mask_t edges;         // bits that changed steady state during the last scan
+  count_t count[N];
+  uint8_t countMode;
+
+  buttonGroupCore(const uint8_t pins[], uint8_t mode, bool pullUpResistor) {
+    sampler.begin(pins, mode);
+    pressedLevel = pullUpResistor ? 0 : (mask_t)~(mask_t)0;
+    countMode = COUNT_PRESSES;
+
+    // bits are stored as pressed (1) or not pressed (0) regardless of resistor configuration
+    steady = sample();
+    edges = 0;
+    for (uint8_t i = 0; i < N; i++)
+      count[i] = 0;
+  }
+
+  // the current reading of the group with pressed bits set
+  mask_t sample(void) { return normalize(sampler.read()); }
+
+  void commitEdges(mask_t changed) {
+    edges = changed;
+    if (!changed)
+      return;
+    steady ^= changed;
+
+    mask_t counted;
+    if (countMode == COUNT_BOTH)
+      counted = edges;
+    else if (countMode == COUNT_PRESSES)
+      counted = pressedMask();
+    else
+      counted = releasedMask();
+
+    mask_t bit = 1;
+    for (uint8_t i = 0; counted; i++, bit <<= 1) {
+      if (counted & bit) {
+        count[i]++;
+        counted &= ~bit;
+      }
+    }
+  }
+
+ private:
+  static mask_t bitOf(uint8_t index) { return (mask_t)1 << index; }
+
+  // one bit for each button in the group
+  static const mask_t usedBits = (mask_t)(((uint32_t)1 << (N - 1)) * 2 - 1);
+
+  // converts between pin levels and pressed bits, the mapping is its own inverse
+  mask_t normalize(mask_t levels) const { return (mask_t)~(levels ^ pressedLevel) & usedBits; }
+};
+
+// debounces each button against its own timer, the same rule button::loop() applies
+template <uint8_t N, typename count_t = unsigned long, class Sampler = portSampler<N> >
+class buttonGroup : public buttonGroupCore<N, count_t, Sampler> {
+  typedef buttonGroupCore<N, count_t, Sampler> core;
+
+ public:
+  typedef typename core::mask_t mask_t;
+
+  buttonGroup(const uint8_t pins[], uint8_t mode, bool pullUpResistor)
+      : core(pins, mode, pullUpResistor) {
+    debounceTime = 0;
+    flickerable = this->steady;
+    for (uint8_t i = 0; i < N; i++)
+      lastDebounceTime[i] = 0;
+  }
+
+  void setDebounceTime(unsigned long time) { debounceTime = time; }
+
+  void loop(void) { loop(millis()); }
+
+  // scan the group against a timestamp shared with the rest of the sketch
+  void loop(unsigned long currentTime) {
+    mask_t reading = this->sample();
+
+    // restart the debounce timer of every button whose reading flickered since the last scan
+    mask_t changed = reading ^ flickerable;
+    flickerable = reading;
+    if (changed) {
+      mask_t bit = 1;
+      for (uint8_t i = 0; changed; i++, bit <<= 1) {
+        if (changed & bit) {
+          lastDebounceTime[i] = currentTime;
+          changed &= ~bit;
+        }
+      }
+    }
+
+    // only buttons whose reading disagrees with their steady state can produce an edge
+    mask_t settled = 0;
+    mask_t pending = flickerable ^ this->steady;
+    if (pending) {
+      mask_t bit = 1;
+      for (uint8_t i = 0; pending; i++, bit <<= 1) {
+        if (pending & bit) {
+          if ((currentTime - lastDebounceTime[i]) >= debounceTime)
+            settled |= bit;
+          pending &= ~bit;
+        }
+      }
+    }
+    this->commitEdges(settled);
+  }
+
+ private:
+  mask_t flickerable;  // the last reading, pressed bits set
+  unsigned long debounceTime;
+  unsigned long lastDebounceTime[N];
+};
+
+// records the events of a group into a buttonEventQueue, with button i of the group as id
+// firstId + i; call update() after every scan of the group. A group reports each edge in the scan
+// it happens, so events are stamped with the time passed to that scan.
+template <uint8_t N>
+class buttonGroupEvents {
+ public:
+  typedef typename buttonMask<N>::type mask_t;
+
+  buttonGroupEvents(buttonEventQueue &queue, uint8_t firstId = 0) : queue(queue), firstId(firstId) {
+    for (uint8_t i = 0; i < N; i++) {
+      heldSince[i] = 0;
+      holdEvents[i] = 0;
+    }
+  }
+
+  template <class Group>
+  void update(const Group &group, unsigned long currentTime) {
+    mask_t pressed = group.pressedMask();
+    mask_t released = group.releasedMask();
+    mask_t held = group.heldMask();
+    if (!queue.holdEventsEnabled() && !(pressed | released))
+      return;
+
+    mask_t bit = 1;
+    for (uint8_t i = 0; i < N; i++, bit <<= 1) {
+      if (pressed & bit) {
+        queue.push(currentTime, BUTTON_PRESS, firstId + i);
+        heldSince[i] = currentTime;
+        holdEvents[i] = 0;
+      } else if (released & bit) {
+        queue.push(currentTime, BUTTON_RELEASE, firstId + i);
+      } else if (held & bit) {
+        queue.pushHoldEvents(firstId + i, heldSince[i], currentTime, holdEvents[i]);
+      }
+    }
+  }
+
+ private:
+  buttonEventQueue &queue;
+  uint8_t firstId;
+  unsigned long heldSince[N];
+  uint16_t holdEvents[N];
+};
+
+#endif
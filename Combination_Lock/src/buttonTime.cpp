@@ -0,0 +1,22 @@
+#include <buttonTime.h>
+
+#if BUTTON_TIMEBASE == BUTTON_TIMEBASE_TICKS
+
+#if defined(__AVR__)
+
+volatile uint16_t buttonTicks;
+
+ISR(TIMER0_COMPB_vect) { buttonTicks++; }
+
+// the core's init() only sets its own bit of TIMSK0, so enabling this before setup() is kept
+void buttonTimeBegin(void) {
+  TIMSK0 |= _BV(OCIE0B);
+}
+
+#else
+
+void buttonTimeBegin(void) {}
+
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/*
+  buttonTime.h
+
+  The clock that button debounces with, chosen at build time with -D BUTTON_TIMEBASE=<base>:
+
+  BUTTON_TIMEBASE_MILLIS  millis(), 32 bits wide (the default)
+  BUTTON_TIMEBASE_TICKS   a 16-bit tick counted by the Timer0 compare B interrupt, one tick per
+                          Timer0 cycle (1.024 ms at 16 MHz), so debouncing compares and subtracts
+                          two bytes instead of four
+  BUTTON_TIMEBASE_MICROS  micros(), 32 bits wide, for debouncing fast encoders and reed switches
+
+  A sketch samples the clock once per scan with buttonNow() and hands the same time to every
+  button's loop(). Times are compared by subtracting them in buttonTime_t, so they stay correct
+  across the wrap as long as no interval being timed is longer than the counter's range: 65 s for
+  the tick, 71 minutes for micros() and 49 days for millis(). A button whose pin hasn't moved
+  doesn't mind being left longer than that; one that is mid-debounce or held for hold events does.
+
+  The tick needs no timer of its own. Timer0 already runs for millis() and its compare B match
+  comes around once per cycle wherever OCR0B is set, so analogWrite() on Timer0's pins is left
+  alone. The interrupt is enabled by the first button constructed. On the native build the tick is
+  derived from the virtual clock, and both 32-bit timebases wrap like they do on an AVR.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef buttonTime_h
+#define buttonTime_h
+
+#include <Arduino.h>
+
+#define BUTTON_TIMEBASE_MILLIS 0
+#define BUTTON_TIMEBASE_TICKS 1
+#define BUTTON_TIMEBASE_MICROS 2
+
+#ifndef BUTTON_TIMEBASE
+#define BUTTON_TIMEBASE BUTTON_TIMEBASE_MILLIS
+#endif
+
+#if BUTTON_TIMEBASE == BUTTON_TIMEBASE_TICKS
+
+typedef uint16_t buttonTime_t;
+
+// Timer0 counts 256 steps with a prescaler of 64
+#if defined(__AVR__)
+const unsigned long buttonTimeUnitMicros = 64UL * 256 * 1000000UL / F_CPU;
+#else
+const unsigned long buttonTimeUnitMicros = 1024;
+#endif
+
+#if defined(__AVR__)
+extern volatile uint16_t buttonTicks;
+
+inline buttonTime_t buttonNow(void) {
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t ticks = buttonTicks;
+  SREG = oldSREG;
+  return ticks;
+}
+#else
+inline buttonTime_t buttonNow(void) { return micros() / buttonTimeUnitMicros; }
+#endif
+
+// start counting ticks, called by the button constructors
+void buttonTimeBegin(void);
+
+#elif BUTTON_TIMEBASE == BUTTON_TIMEBASE_MICROS
+
+typedef uint32_t buttonTime_t;
+const unsigned long buttonTimeUnitMicros = 1;
+
+inline buttonTime_t buttonNow(void) { return micros(); }
+inline void buttonTimeBegin(void) {}
+
+#elif BUTTON_TIMEBASE == BUTTON_TIMEBASE_MILLIS
+
+typedef uint32_t buttonTime_t;
+const unsigned long buttonTimeUnitMicros = 1000;
+
+inline buttonTime_t buttonNow(void) { return millis(); }
+inline void buttonTimeBegin(void) {}
+
+#else
+#error "BUTTON_TIMEBASE must be one of BUTTON_TIMEBASE_MILLIS, _TICKS or _MICROS"
+#endif
+
+// whole units of the timebase lasting at least the given time, saturated at 0xFFFF
+inline uint16_t buttonTimeFromMicros(unsigned long us) {
+  unsigned long units = us / buttonTimeUnitMicros + (us % buttonTimeUnitMicros != 0);
+  return units < 0xFFFF ? units : 0xFFFF;
+}
+
+inline uint16_t buttonTimeFromMillis(unsigned long ms) {
+  if (ms >= 0xFFFFUL * buttonTimeUnitMicros / 1000)
+    return 0xFFFF;
+  return buttonTimeFromMicros(ms * 1000);
+}
+
+#endif
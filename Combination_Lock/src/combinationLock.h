@@ -0,0 +1,408 @@
+/*
+  combinationLock.h
+
+  One combination lock: its state, combo matcher, input timeout, lockout and red LED, with no pins
+  of its own. The sketch scans the buttons and writes the outputs, and feeds every lock the same
+  timestamp, so one board can run as many locks as it has pins for, each with its own combos,
+  attempt log and flash settings. The locks read their timeout and lockout from a lockSettings,
+  which several locks may share.
+
+  typedef combinationLock<lockComboSet, 3, 1> lock_t;  // combo set, combo buttons, accessories
+  lockScheduler lockTimers;                            // the timers of the sketch's locks
+  lock_t lock(lockComboTable, COMBO_BLOCK, config.settings(), attemptLog, lockTimers, 5, 100);
+
+  lock.begin(millis());                        // after attemptLog.begin(), resumes a lockout
+  lock.prime(now);                             // the priming button was pressed
+  lock.update(now, pressedMask, heldMask);     // the combo buttons of this scan, bit i for button i
+  outputs.write(lock.outputs());               // accessories, then green, blue and red LEDs
+
+  Outputs are a bitmask: bit a for accessory a, the one a combo's action selects, then the green,
+  blue and red LEDs. By default the red LED is a plain output too, flashed by a task run from
+  update() and lit steadily during a lockout. attachRedLed() hands it to the LED pattern
+  engine instead (see ledPatterns.h), which flashes it from a timer interrupt and breathes it during
+  a lockout; its bit then stays clear.
+
+  The states are the sketch's: not primed, primed, correct combo, incorrect combo and locked out.
+  Each is a row of a table in flash listing the outputs it drives and its entry, update and exit
+  actions.
+
+  The combo input timeout and the lockout are one-shot tasks of a cooperativeScheduler, and the
+  plain red LED's flashing a periodic one, so a pass with nothing due looks at a single deadline however many
+  locks there are. The locks of a sketch share one scheduler with room for lockTasks timers each,
+  lockScheduler for a single lock, and update() runs whatever is due on it. A sketch with four
+  locks declares cooperativeScheduler<4 * lockTasks> and gives it as the lock's Tasks type.
+
+  updateLocks() services several locks of one type from one buttonGroup holding each lock's keys
+  back to back, its priming button and then its combo buttons, and returns all of their outputs for
+  one outputGroup. On a Mega eight locks with three combo buttons and one accessory take 32 keys and
+  32 outputs. A pass costs the locks one look at the scheduler's earliest deadline, and each lock
+  one table lookup per combo press and at most one state change, so the loop time grows linearly
+  with the locks and doesn't depend on what they are doing; the exception is the EEPROM, where an
+  attempt that is logged waits for its record to be written (lockLog.h), about 30 ms, and locks
+  logging in the same pass wait in turn.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef combinationLock_h
+#define combinationLock_h
+
+#include <Arduino.h>
+#include <buttonGestures.h>
+#include <buttonGroup.h>  // buttonMask
+#include <comboSet.h>
+#include <cooperativeScheduler.h>
+#include <ledPatterns.h>
+#include <lockConfig.h>
+#include <lockLog.h>
+
+enum lockState { LOCK_NOT_PRIMED,
+                 LOCK_PRIMED,
+                 LOCK_CORRECT_COMBO,
+                 LOCK_INCORRECT_COMBO,
+                 LOCK_LOCKED_OUT,
+                 LOCK_STATE_COUNT };
+
+// the timers a lock can have pending at once: its combo input timeout or lockout, and the red flash
+const uint8_t lockTasks = 2;
+
+// room for the timers of one lock
+typedef cooperativeScheduler<lockTasks> lockScheduler;
+
+// with Chords, combos are entered as chords of buttons pressed together (see buttonGestures.h); the
+// attempts go to a lockLog, or anything with its record, flush and query functions; the timers run
+// on a scheduler of type Tasks shared with the sketch's other locks
+template <class Set, uint8_t Buttons, uint8_t Accessories = 1, bool Chords = false,
+          class Log = lockLog, class Tasks = lockScheduler>
+class combinationLock {
+  static_assert(Buttons > 0 && Buttons <= 31, "a lock has between 1 and 31 combo buttons");
+  static_assert(!Chords || Buttons <= 8, "chords are made of up to 8 buttons");
+  static_assert(Accessories > 0 && Accessories <= 5, "a lock drives between 1 and 5 accessories");
+  static_assert(Set::symbols == (Chords ? (1 << Buttons) - 1 : Buttons),
+                "the combo set must have a symbol per button, or per chord of buttons");
+
+ public:
+  typedef typename buttonMask<Buttons>::type mask_t;
+
+  // the priming button and the combo buttons
+  static const uint8_t keys = Buttons + 1;
+
+  // bits of outputs()
+  static const uint8_t greenLed = Accessories;
+  static const uint8_t blueLed = Accessories + 1;
+  static const uint8_t redLed = Accessories + 2;
+  static const uint8_t outputCount = Accessories + 3;
+
+  // the set is read in place, on AVR it must be declared PROGMEM; the red LED flashes flashCount
+  // times after an incorrect combo, flashInterval milliseconds on and then off
+  combinationLock(const Set &combos, comboMatchMode mode, const lockSettings &settings,
+                  Log &history, Tasks &tasks, uint8_t flashCount, uint16_t flashInterval)
+      : matcher(combos, mode),
+        settings(settings),
+        history(history),
+        tasks(tasks),
+        flashCount(flashCount),
+        flashInterval(flashInterval),
+        redChannel(ledNoChannel),
+        flashPattern(NULL),
+        current(LOCK_NOT_PRIMED),
+        levels(bitOf(blueLed)),
+        timeOutTask(noTask),
+        lockoutTask(noTask),
+        flashTask(noTask),
+        redToggles(0) {}
+
+  // the scheduler outlives the lock, its timers mustn't
+  ~combinationLock() {
+    tasks.cancel(timeOutTask);
+    tasks.cancel(lockoutTask);
+    tasks.cancel(flashTask);
+  }
+
+  // play the red LED's flashing, with steps of flashInterval, and its lockout on a pattern channel
+  void attachRedLed(uint8_t channel, const ledPattern *flash) {
+    redChannel = channel;
+    flashPattern = flash;
+    levels &= ~bitOf(redLed);
+  }
+
+  // resume a lockout the board was reset during, once the attempt log has been read
+  void begin(unsigned long now) {
+    if (history.lockedOut())
+      changeState(LOCK_LOCKED_OUT, now);
+  }
+
+  // the priming button was pressed: (re)start the combo input window, ignored while locked out
+  void prime(unsigned long now) {
+    // an incorrect combo that calls for a lockout isn't undone by priming before the next update
+    if (current == LOCK_INCORRECT_COMBO && lockoutTime() != 0)
+      changeState(LOCK_LOCKED_OUT, now);
+    if (current == LOCK_LOCKED_OUT)
+      return;
+    tasks.cancel(timeOutTask);
+    timeOutTask = tasks.schedule(now, settings.comboInputTimeOut, 0, timedOut, this);
+    changeState(LOCK_PRIMED, now);
+  }
+
+  // run the timers that are due and the current state, given the combo buttons pressed in this
+  // scan and those held, bit i for button i; the first lock updated in a pass runs the timers of
+  // every lock sharing the scheduler, the others find nothing left due
+  void update(unsigned long now, mask_t pressed, mask_t held) {
+    tasks.run(now);
+
+    void (combinationLock::*updateState)(unsigned long, mask_t, mask_t) = stateRow(current).update;
+    if (updateState != NULL)
+      (this->*updateState)(now, pressed, held);
+  }
+
+  // time until update() next has something to do without any button being pressed, zero if it has
+  // now, noDeadline if nothing is pending; the timers of locks sharing the scheduler count too
+  unsigned long timeUntilNextEvent(unsigned long now) const {
+    if (current == LOCK_INCORRECT_COMBO)
+      return 0;  // decided on the next update
+    return tasks.timeUntilNextTask(now);
+  }
+
+  uint8_t outputs(void) const { return levels; }
+  uint8_t state(void) const { return current; }
+
+  // the combo buttons are being read, they can be left unscanned otherwise
+  bool listening(void) const { return current == LOCK_PRIMED; }
+
+  // unprimed with no timer running and the red LED still, so nothing happens until primed
+  bool idle(void) const {
+    return current == LOCK_NOT_PRIMED && timeOutTask == noTask && lockoutTask == noTask &&
+           flashTask == noTask;
+  }
+
+ private:
+  // each state sets its outputs once on entry, then runs its entry action
+  // while a state is current its update action runs on every update, before it is left its exit
+  struct stateActions {
+    uint8_t outputLevels;   // levels of the outputs the state drives, bit per output
+    uint8_t outputsDriven;  // outputs the state drives, others keep their level
+    void (combinationLock::*enter)(unsigned long now);
+    void (combinationLock::*update)(unsigned long now, mask_t pressed, mask_t held);
+    void (combinationLock::*exit)(void);
+  };
+
+  // every output but the red LED, which the states start and stop rather than drive
+  static const uint8_t stateOutputs = (uint8_t)((1 << redLed) - 1);
+
+  static const stateActions states[LOCK_STATE_COUNT] PROGMEM;
+
+  comboSetMatcher<Set> matcher;
+  buttonGestures<Chords ? Buttons : 1> gestures;
+  const lockSettings &settings;
+  Log &history;
+  Tasks &tasks;
+  uint8_t flashCount;
+  uint16_t flashInterval;
+  uint8_t redChannel;
+  const ledPattern *flashPattern;
+
+  uint8_t current;
+  uint8_t levels;          // bit per output
+  taskHandle timeOutTask;  // scheduled while the combo input window is open
+  taskHandle lockoutTask;
+  taskHandle flashTask;  // flashing the red LED, not used on a pattern channel
+  uint16_t redToggles;   // red LED toggles left in the flashing
+
+  static constexpr uint8_t bitOf(uint8_t output) { return (uint8_t)(1 << output); }
+
+  // the combo input window closed
+  static void timedOut(void *context) {
+    combinationLock &lock = *(combinationLock *)context;
+    lock.timeOutTask = noTask;
+    lock.history.flush();  // the window's incorrect combos are written together
+    if (lock.current == LOCK_PRIMED)
+      lock.changeState(LOCK_NOT_PRIMED, lock.tasks.lastRun());
+  }
+
+  static void lockoutEnded(void *context) {
+    combinationLock &lock = *(combinationLock *)context;
+    lock.lockoutTask = noTask;
+    lock.history.recordLockout(false);
+    lock.changeState(LOCK_NOT_PRIMED, lock.tasks.lastRun());
+  }
+
+  // every flash interval, until the last toggle leaves the red LED off
+  static void toggleRed(void *context) {
+    combinationLock &lock = *(combinationLock *)context;
+    lock.levels ^= bitOf(redLed);
+    if (--lock.redToggles == 0)
+      lock.tasks.cancel(lock.flashTask);
+  }
+
+  // kept in flash, read a row with stateRow()
+  static stateActions stateRow(uint8_t state) {
+    stateActions row;
+    memcpy_P(&row, &states[state], sizeof(row));
+    return row;
+  }
+
+  // leave the current state and enter the next one, re-entering the current state is allowed
+  void changeState(uint8_t nextState, unsigned long now) {
+    void (combinationLock::*exit)(void) = stateRow(current).exit;
+    if (exit != NULL)
+      (this->*exit)();
+    current = nextState;
+
+    stateActions state = stateRow(current);
+    levels = (levels & ~state.outputsDriven) | (state.outputLevels & state.outputsDriven);
+    if (state.enter != NULL)
+      (this->*state.enter)(now);
+  }
+
+  void enterPrimed(unsigned long) {
+    matcher.reset();
+    gestures.reset();
+  }
+
+  void updatePrimed(unsigned long now, mask_t pressed, mask_t held) {
+    // feed each press or chord of the scan to the matcher
+    comboResult result = COMBO_PENDING;
+    if (Chords) {
+      gestures.update((uint8_t)held, now);
+      gesture chord;
+      while (gestures.read(chord) && result == COMBO_PENDING)
+        result = matcher.press(gestures.chordSymbol(chord.keys));
+    } else {
+      for (uint8_t i = 0; pressed && result == COMBO_PENDING; i++, pressed >>= 1) {
+        if (pressed & 1)
+          result = matcher.press(i);
+      }
+    }
+
+    // a combo was completed
+    if (result == COMBO_MATCHED)
+      changeState(LOCK_CORRECT_COMBO, now);
+    else if (result == COMBO_REJECTED)
+      changeState(LOCK_INCORRECT_COMBO, now);
+  }
+
+  void enterCorrectCombo(unsigned long) {
+    // stop flashing red if the combo came after an incorrect one but before flashing completed
+    stopRed();
+
+    // the accessory stays on until the priming button is pressed again
+    uint8_t accessory = matcher.matchedAction();
+    if (accessory < Accessories)
+      levels |= bitOf(accessory);
+    tasks.cancel(timeOutTask);
+    history.recordSuccess();
+  }
+
+  void enterIncorrectCombo(unsigned long now) {
+    // turn the red LED on right away and flash it flashCount times, without blocking further
+    // attempts; it ends off
+    if (redChannel != ledNoChannel) {
+      ledPatterns::play(redChannel, flashPattern, flashCount);
+    } else if (flashCount > 0 && flashInterval > 0) {
+      levels |= bitOf(redLed);
+      redToggles = 2 * (uint16_t)flashCount - 1;
+      tasks.cancel(flashTask);
+      flashTask = tasks.schedule(now, flashInterval, flashInterval, toggleRed, this);
+    }
+    history.recordFailure();
+  }
+
+  void updateIncorrectCombo(unsigned long now, mask_t, mask_t) {
+    // re-prime for additional attempts within the input window, unless that was too many or the
+    // window closed in the meantime
+    if (lockoutTime() != 0)
+      changeState(LOCK_LOCKED_OUT, now);
+    else if (timeOutTask != noTask)
+      changeState(LOCK_PRIMED, now);
+    else
+      changeState(LOCK_NOT_PRIMED, now);
+  }
+
+  void enterLockedOut(unsigned long now) {
+    tasks.cancel(timeOutTask);
+    if (!history.lockedOut())  // not when resuming a lockout logged before a reset
+      history.recordLockout(true);
+    tasks.cancel(lockoutTask);
+    lockoutTask = tasks.schedule(now, lockoutTime(), 0, lockoutEnded, this);
+    if (redChannel != ledNoChannel) {
+      ledPatterns::play(redChannel, &ledBreathe);
+    } else {
+      tasks.cancel(flashTask);
+      levels |= bitOf(redLed);
+    }
+  }
+
+  void exitLockedOut(void) {
+    tasks.cancel(lockoutTask);
+    stopRed();
+  }
+
+  void stopRed(void) {
+    if (redChannel != ledNoChannel) {
+      ledPatterns::stop(redChannel);
+    } else {
+      tasks.cancel(flashTask);
+      levels &= ~bitOf(redLed);
+    }
+  }
+
+  // no lockout until lockoutFreeAttempts incorrect combos in a row, then doubling with each one
+  // after
+  unsigned long lockoutTime(void) const {
+    uint8_t failures = history.failures();
+    if (failures < settings.lockoutFreeAttempts)
+      return 0;
+    uint8_t doublings = failures - settings.lockoutFreeAttempts;
+    if (doublings > settings.lockoutMaxDoublings)
+      doublings = settings.lockoutMaxDoublings;
+    return settings.comboInputTimeOut << doublings;
+  }
+};
+
+template <class Set, uint8_t Buttons, uint8_t Accessories, bool Chords, class Log, class Tasks>
+const typename combinationLock<Set, Buttons, Accessories, Chords, Log, Tasks>::stateActions
+    combinationLock<Set, Buttons, Accessories, Chords, Log, Tasks>::states[LOCK_STATE_COUNT]
+        PROGMEM = {
+        // LOCK_NOT_PRIMED: blue LED on, waiting for the priming button
+        {bitOf(blueLed), stateOutputs, NULL, NULL, NULL},
+        // LOCK_PRIMED: everything off, listening for combo buttons
+        {0, stateOutputs, &combinationLock::enterPrimed, &combinationLock::updatePrimed, NULL},
+        // LOCK_CORRECT_COMBO: green LED and the combo's accessory on until primed again
+        {bitOf(greenLed), stateOutputs, &combinationLock::enterCorrectCombo, NULL, NULL},
+        // LOCK_INCORRECT_COMBO: start flashing red, then re-prime or lock out on the next update
+        {0, 0, &combinationLock::enterIncorrectCombo, &combinationLock::updateIncorrectCombo,
+         NULL},
+        // LOCK_LOCKED_OUT: everything off but the red LED, priming ignored until the lockout ends
+        {0, stateOutputs, &combinationLock::enterLockedOut, NULL, &combinationLock::exitLockedOut},
+};
+
+// service locks that share one button scan: lock i's keys are at bits i * Lock::keys on of the
+// group, its priming button and then its combo buttons; returns the outputs of every lock, lock i's
+// at bits i * Lock::outputCount on
+template <class Lock, uint8_t Count, class Group>
+uint32_t updateLocks(Lock (&locks)[Count], const Group &keys, unsigned long now) {
+  static_assert(Count * Lock::keys <= 32, "a button group holds up to 32 keys");
+  static_assert(Count * Lock::outputCount <= 32, "an output group holds up to 32 outputs");
+  const uint32_t comboButtons = ((uint32_t)1 << (Lock::keys - 2)) * 2 - 1;
+
+  uint32_t pressed = keys.pressedMask();
+  uint32_t held = keys.heldMask();
+  uint32_t outputs = 0;
+  for (uint8_t i = 0; i < Count; i++) {
+    if (pressed & 1)
+      locks[i].prime(now);
+    locks[i].update(now, (pressed >> 1) & comboButtons, (held >> 1) & comboButtons);
+    outputs |= (uint32_t)locks[i].outputs() << (i * Lock::outputCount);
+    // in two steps, a single lock may have all 32 keys
+    pressed = (pressed >> (Lock::keys - 1)) >> 1;
+    held = (held >> (Lock::keys - 1)) >> 1;
+  }
+  return outputs;
+}
+
+#endif
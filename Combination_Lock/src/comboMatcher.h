@@ -0,0 +1,148 @@
+/*
+  comboMatcher.h
+
+  Streaming combo matching. Instead of buffering a full combo and comparing it afterwards, each
+  button press advances a small automaton by one state, so a press costs a single table lookup no
+  matter how long the combo is, and no input buffer is kept.
+
+  The automaton is the KMP string-matching automaton of the combo: state n means the last n presses
+  match the first n symbols of the combo, and next[n][symbol] is the longest such match after one
+  more press. It is built by the compiler from a constexpr combo and stored in flash, taking
+  (length + 1) * symbols bytes of program memory and none of SRAM:
+
+  constexpr uint8_t combo[] = {0, 1, 2};
+  constexpr comboAutomaton<3, 3> automaton PROGMEM = buildComboAutomaton<3>(combo);
+  comboMatcher<3, 3> matcher(automaton, COMBO_BLOCK);
+
+  if (buttons.isPressed(i) && matcher.press(i) == COMBO_MATCHED)
+    unlock();
+
+  Two modes are supported:
+  - COMBO_BLOCK....Presses are taken in blocks of the combo length, like a keypad with a fixed code
+                   length. After every full block press() reports COMBO_MATCHED or COMBO_REJECTED
+                   and the matcher starts over. Which press was wrong isn't revealed, neither by
+                   the result nor by the time a press takes: every press of a block does the same
+                   work whether or not the presses before it were right.
+  - COMBO_ROLLING..The combo matches as soon as the most recent presses spell it, whatever came
+                   before; nothing is ever rejected. Matches may overlap, so after a match the
+                   matcher keeps going from the longest part of the combo that is still useful.
+
+  Rolling mode is convenient but lets someone try many combos in one long sequence of presses, so
+  pair it with an entry timeout.
+
+  The combo must be a constant expression with every symbol below the symbol count; a symbol out of
+  range stops compilation. Building the automaton needs C++14 constexpr rules, so the environments
+  compile with -std=gnu++17.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef comboMatcher_h
+#define comboMatcher_h
+
+#include <Arduino.h>
+
+enum comboMatchMode { COMBO_BLOCK,
+                      COMBO_ROLLING };
+
+enum comboResult { COMBO_PENDING,  // the combo isn't complete yet
+                   COMBO_MATCHED,
+                   COMBO_REJECTED };
+
+// not constexpr, so a combo symbol out of range fails to compile where the automaton is built
+void comboSymbolOutOfRange(void);
+
+template <uint8_t Symbols, uint8_t Length>
+struct comboAutomaton {
+  static_assert(Symbols > 0, "a combo needs at least one symbol");
+  static_assert(Length > 0 && Length < 255, "combo length must be between 1 and 254");
+
+  uint8_t next[Length + 1][Symbols];  // next[state][symbol], state Length is a full match
+
+  constexpr comboAutomaton(const uint8_t (&combo)[Length]) : next() {
+    for (uint8_t i = 0; i < Length; i++) {
+      if (combo[i] >= Symbols)
+        comboSymbolOutOfRange();
+    }
+
+    // restart is the state the automaton would be in had the first symbol of the input so far
+    // never been pressed; on a mismatch state n falls back to wherever restart goes
+    next[0][combo[0]] = 1;
+    uint8_t restart = 0;
+    for (uint8_t state = 1; state <= Length; state++) {
+      for (uint8_t symbol = 0; symbol < Symbols; symbol++)
+        next[state][symbol] = next[restart][symbol];
+      if (state < Length) {
+        next[state][combo[state]] = state + 1;
+        restart = next[restart][combo[state]];
+      }
+    }
+  }
+
+  // the automaton may live in flash, so it is only ever read through here
+  uint8_t step(uint8_t state, uint8_t symbol) const { return pgm_read_byte(&next[state][symbol]); }
+};
+
+// buildComboAutomaton<symbols>(combo) works out the combo length itself
+template <uint8_t Symbols, uint8_t Length>
+constexpr comboAutomaton<Symbols, Length> buildComboAutomaton(const uint8_t (&combo)[Length]) {
+  return comboAutomaton<Symbols, Length>(combo);
+}
+
+template <uint8_t Symbols, uint8_t Length>
+class comboMatcher {
+ public:
+  typedef comboAutomaton<Symbols, Length> automaton_t;
+
+  // the automaton is read in place, on AVR it must be declared PROGMEM
+  comboMatcher(const automaton_t &automaton, comboMatchMode mode = COMBO_BLOCK)
+      : automaton(automaton), mode(mode), state(0), entered(0), mismatch(0) {}
+
+  // advance by one press, symbols out of range are ignored
+  comboResult press(uint8_t symbol) {
+    if (symbol >= Symbols)
+      return COMBO_PENDING;
+
+    if (mode == COMBO_ROLLING) {
+      state = automaton.step(state, symbol);
+      return state == Length ? COMBO_MATCHED : COMBO_PENDING;
+    }
+
+    // in blocks only an unbroken prefix counts; a wrong press is only noted and the automaton keeps
+    // stepping, so every press takes the same path whether or not the presses before it were right
+    uint8_t nextState = automaton.step(state, symbol);
+    mismatch |= nextState ^ (uint8_t)(state + 1);
+    state = nextState;
+    if (++entered < Length)
+      return COMBO_PENDING;
+    comboResult result = mismatch == 0 ? COMBO_MATCHED : COMBO_REJECTED;
+    reset();
+    return result;
+  }
+
+  // forget every press so far
+  void reset(void) {
+    state = 0;
+    entered = 0;
+    mismatch = 0;
+  }
+
+  void setMode(comboMatchMode newMode) {
+    mode = newMode;
+    reset();
+  }
+
+ private:
+  const automaton_t &automaton;
+  comboMatchMode mode;
+  uint8_t state;
+  uint8_t entered;
+  uint8_t mismatch;  // nonzero once a press of the block left the combo
+};
+
+#endif
@@ -0,0 +1,245 @@
+/*
+  comboSet.h
+
+  Matching against many combos at once, for locks shared by several users who each have their own
+  code, possibly opening their own accessory. This is the multi-combo counterpart of comboMatcher.h:
+  the combos are merged into a trie and turned into an Aho-Corasick automaton by the compiler, and
+  the automaton is stored in flash. A press is still a single table lookup, however many combos
+  there are.
+
+  Combos are listed back to back in one constexpr array, each one ended by the action it triggers.
+  An action is any number from 0 to 126, such as the index of an output to switch on:
+
+  constexpr uint8_t combos[] = {
+      0, 1, 2, comboAction(0),
+      2, 2, 1, 0, comboAction(1),
+  };
+  typedef comboSet<3, comboSetNodes<3>(combos)> combos_t;
+  constexpr combos_t comboTable PROGMEM = combos_t(combos);
+  comboSetMatcher<combos_t> matcher(comboTable, COMBO_BLOCK);
+
+  if (buttons.isPressed(i) && matcher.press(i) == COMBO_MATCHED)
+    unlock(matcher.matchedAction());
+
+  comboSetNodes() counts the trie nodes, one per distinct combo prefix plus the root, so the table
+  is exactly as large as it needs to be. Each node takes one byte per symbol, two bytes per symbol
+  once there are more than 255 nodes, plus two bytes for its depth and output. A hundred 6-press
+  combos over 3 buttons fit in about 2 KB of flash, and none of them use SRAM.
+
+  The modes mean the same as in comboMatcher.h:
+  - COMBO_BLOCK....Presses must spell a combo from the start of the block. A block ends with
+                   COMBO_MATCHED as soon as a combo is complete, or with COMBO_REJECTED once as
+                   many presses as the longest combo has were made without one. A combo that
+                   starts with another whole combo can never match in this mode. Every press of a
+                   block takes the same time whether or not the presses before it were right.
+  - COMBO_ROLLING..A combo matches as soon as the most recent presses spell it. When several end
+                   on the same press, the longest one wins.
+
+  A malformed list, such as a symbol out of range, a combo with no presses or presses left without
+  an action at the end, stops compilation.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef comboSet_h
+#define comboSet_h
+
+#include <comboMatcher.h>  // comboMatchMode, comboResult
+
+const uint8_t comboNoAction = 0x7F;
+
+// ends a combo in a combo list, actions are 0 to 126
+constexpr uint8_t comboAction(uint8_t action) {
+  return 0x80 | action;
+}
+
+// not constexpr, so a malformed combo list fails to compile where the set is built
+void comboListInvalid(void);
+
+// nodes needed for a combo list, the root plus one per distinct combo prefix
+template <uint8_t Symbols, size_t Size>
+constexpr uint16_t comboSetNodes(const uint8_t (&list)[Size]) {
+  uint16_t child[Size + 1][Symbols] = {};
+  uint16_t nodes = 1;
+  uint16_t node = 0;
+  for (size_t i = 0; i < Size; i++) {
+    if (list[i] & 0x80) {
+      node = 0;
+    } else if (list[i] < Symbols) {
+      if (child[node][list[i]] == 0)
+        child[node][list[i]] = nodes++;
+      node = child[node][list[i]];
+    }
+  }
+  return nodes;
+}
+
+template <bool Wide>
+struct comboNodeSelect {
+  typedef uint8_t type;
+};
+template <>
+struct comboNodeSelect<true> {
+  typedef uint16_t type;
+};
+
+template <uint8_t Symbols, uint16_t Nodes>
+struct comboSet {
+  static_assert(Symbols > 0 && Symbols < 0x80, "symbol count must be between 1 and 127");
+  static_assert(Nodes > 1, "a combo set needs at least one combo");
+  static_assert(Nodes < 0xFFFF, "too many combo nodes");
+
+  typedef typename comboNodeSelect<(Nodes > 255)>::type node_t;
+
+  static const uint8_t symbols = Symbols;
+  static const uint8_t terminal = 0x80;  // output flag of a node where a combo ends
+
+  node_t next[Nodes][Symbols];  // next[node][symbol], node 0 is the root
+  uint8_t depth[Nodes];         // presses from the root
+  uint8_t output[Nodes];        // action of the longest combo ending here, flagged if its own
+  uint8_t longest;              // presses in the longest combo
+
+  template <size_t Size>
+  constexpr comboSet(const uint8_t (&list)[Size]) : next(), depth(), output(), longest(0) {
+    for (uint16_t i = 0; i < Nodes; i++)
+      output[i] = comboNoAction;
+
+    // the trie, where next only holds edges to children and zero means no child
+    uint16_t nodes = 1;
+    node_t node = 0;
+    for (size_t i = 0; i < Size; i++) {
+      uint8_t symbol = list[i];
+      if (symbol & 0x80) {
+        if (node == 0 || symbol == comboAction(comboNoAction))
+          comboListInvalid();
+        if (!(output[node] & terminal))  // a repeated combo keeps its first action
+          output[node] = terminal | (symbol & 0x7F);
+        node = 0;
+        continue;
+      }
+      if (symbol >= Symbols)
+        comboListInvalid();
+      if (next[node][symbol] == 0) {
+        if (nodes >= Nodes || depth[node] == 0xFF)
+          comboListInvalid();
+        next[node][symbol] = nodes;
+        depth[nodes] = depth[node] + 1;
+        if (depth[nodes] > longest)
+          longest = depth[nodes];
+        nodes++;
+      }
+      node = next[node][symbol];
+    }
+    if (node != 0 || nodes != Nodes)
+      comboListInvalid();
+
+    // breadth first, so every node's fallback is finished before the node itself; missing edges
+    // are filled in from the fallback, the longest proper suffix of the node that is also a prefix
+    node_t queue[Nodes] = {};
+    node_t fallback[Nodes] = {};
+    uint16_t head = 0;
+    uint16_t tail = 0;
+    for (uint8_t symbol = 0; symbol < Symbols; symbol++) {
+      if (next[0][symbol] != 0)
+        queue[tail++] = next[0][symbol];
+    }
+    while (head < tail) {
+      node_t parent = queue[head++];
+      if (output[parent] == comboNoAction)
+        output[parent] = output[fallback[parent]] & ~terminal;
+      for (uint8_t symbol = 0; symbol < Symbols; symbol++) {
+        node_t child = next[parent][symbol];
+        if (child != 0) {
+          fallback[child] = next[fallback[parent]][symbol];
+          queue[tail++] = child;
+        } else {
+          next[parent][symbol] = next[fallback[parent]][symbol];
+        }
+      }
+    }
+  }
+
+  // the set may live in flash, so it is only ever read through these
+  node_t step(node_t node, uint8_t symbol) const { return read(&next[node][symbol]); }
+  uint8_t depthOf(node_t node) const { return pgm_read_byte(&depth[node]); }
+  uint8_t outputOf(node_t node) const { return pgm_read_byte(&output[node]); }
+  uint8_t longestCombo(void) const { return pgm_read_byte(&longest); }
+
+ private:
+  static uint8_t read(const uint8_t *address) { return pgm_read_byte(address); }
+  static uint16_t read(const uint16_t *address) { return pgm_read_word(address); }
+};
+
+template <class Set>
+class comboSetMatcher {
+ public:
+  typedef typename Set::node_t node_t;
+
+  // the set is read in place, on AVR it must be declared PROGMEM
+  comboSetMatcher(const Set &set, comboMatchMode mode = COMBO_BLOCK)
+      : set(set), mode(mode), node(0), entered(0), offTrie(0), matched(comboNoAction) {}
+
+  // advance by one press, symbols out of range are ignored
+  comboResult press(uint8_t symbol) {
+    if (symbol >= Set::symbols)
+      return COMBO_PENDING;
+
+    if (mode == COMBO_ROLLING) {
+      node = set.step(node, symbol);
+      uint8_t action = set.outputOf(node) & ~Set::terminal;
+      if (action == comboNoAction)
+        return COMBO_PENDING;
+      matched = action;
+      return COMBO_MATCHED;
+    }
+
+    // in blocks only edges of the trie count, anything else rejects the rest of the block; leaving
+    // the trie is only noted and the automaton keeps stepping, so every press does the same work
+    // whether or not the presses before it were right
+    node_t nextNode = set.step(node, symbol);
+    offTrie |= set.depthOf(nextNode) ^ (uint8_t)(set.depthOf(node) + 1);
+    node = nextNode;
+    entered++;
+    // the node's output, masked to nothing without a branch once the block has left the trie
+    uint8_t output = set.outputOf(node) & (uint8_t)(((uint16_t)offTrie - 1) >> 8);
+    if (output & Set::terminal) {
+      matched = output & ~Set::terminal;
+      reset();
+      return COMBO_MATCHED;
+    }
+    if (entered < set.longestCombo())
+      return COMBO_PENDING;
+    reset();
+    return COMBO_REJECTED;
+  }
+
+  // forget every press so far
+  void reset(void) {
+    node = 0;
+    entered = 0;
+    offTrie = 0;
+  }
+
+  void setMode(comboMatchMode newMode) {
+    mode = newMode;
+    reset();
+  }
+
+  // action of the combo last matched, comboNoAction before the first match
+  uint8_t matchedAction(void) const { return matched; }
+
+ private:
+  const Set &set;
+  comboMatchMode mode;
+  node_t node;
+  uint8_t entered;
+  uint8_t offTrie;  // nonzero once a press of the block left the trie
+  uint8_t matched;
+};
+
+#endif
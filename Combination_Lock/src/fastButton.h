@@ -0,0 +1,122 @@
+/*
+  fastButton.h
+
+  A header-only, compile-time configured variant of the button library. Where button keeps its pin,
+  resistor configuration, count mode and debounce time in RAM and checks them on every call,
+  fastButton takes them as template parameters:
+
+  fastButton<8> button1;                                     // like button button1(8);
+  fastButton<13, INPUT, false> button2;                      // like button button2(13, INPUT, false);
+  fastButton<9, INPUT, false, COUNT_BOTH, 50> button3;       // plus count mode and debounce time
+
+  The compiler resolves the pull-up or pull-down polarity and the count mode, so isPressed(),
+  isReleased() and loop() contain no branches on configuration. On the ATmega328P and ATmega168
+  (Uno, Nano, Pro Mini) the pin is also mapped to its port register and bit at compile time and read
+  with a single instruction instead of going through digitalRead(). Other boards fall back to
+  digitalRead() with everything else unchanged. Each instance keeps only its debounce timer, its
+  count, and one byte of state flags.
+
+  The queries match button. isPressed() and isReleased() are true for the single loop() call in
+  which the debounced state changes, and getCount() counts presses, releases, or both. Because the
+  configuration is fixed, setDebounceTime() and setCountMode() are not available. The runtime button
+  class stays the default choice; use this one where flash, RAM or cycles are tight. The
+  uno_size_button and uno_size_fast_button environments build one of each for an Uno to compare
+  flash and RAM, and bench_fast_button checks that the two agree on a bouncing trace and times
+  their loop() on the host.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef fastButton_h
+#define fastButton_h
+
+#include <button.h>
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+#define FAST_BUTTON_DIRECT_PORTS
+
+// data space addresses of PIND, PINB and PINC, digital pins 0-7, 8-13 and 14-19 (A0-A5)
+constexpr uint8_t fastButtonInputAddress(uint8_t pin) {
+  return pin < 8 ? 0x29 : (pin < 14 ? 0x23 : 0x26);
+}
+
+constexpr uint8_t fastButtonBitMask(uint8_t pin) {
+  return 1 << (pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14));
+}
+#endif
+
+template <uint8_t Pin,
+          uint8_t Mode = INPUT_PULLUP,
+          bool PullUp = true,
+          uint8_t CountMode = COUNT_PRESSES,
+          unsigned long DebounceTime = 0>
+class fastButton {
+#ifdef FAST_BUTTON_DIRECT_PORTS
+  static_assert(Pin < 20, "fastButton pin must be a digital pin from 0 to 19");
+#endif
+
+ public:
+  fastButton() {
+    pinMode(Pin, Mode);
+    uint8_t level = getStateRaw();
+    flags = level ? (STEADY | FLICKERABLE) : 0;
+    lastDebounceTime = 0;
+    count = 0;
+  }
+
+  int getState(void) const { return (flags & STEADY) ? HIGH : LOW; }
+
+  static int getStateRaw(void) {
+#ifdef FAST_BUTTON_DIRECT_PORTS
+    return (*(volatile uint8_t *)fastButtonInputAddress(Pin) & fastButtonBitMask(Pin)) ? HIGH : LOW;
+#else
+    return digitalRead(Pin);
+#endif
+  }
+
+  bool isPressed(void) const { return (flags & EDGE) && steadyPressed(); }
+  bool isReleased(void) const { return (flags & EDGE) && !steadyPressed(); }
+  unsigned long getCount(void) const { return count; }
+  void resetCount(void) { count = 0; }
+
+  void loop(void) { loop(millis()); }
+
+  void loop(unsigned long currentTime) {
+    uint8_t reading = getStateRaw() ? FLICKERABLE : 0;
+
+    // restart the debounce timer whenever the reading flickers
+    if (reading != (flags & FLICKERABLE)) {
+      lastDebounceTime = currentTime;
+      flags ^= FLICKERABLE;
+    }
+
+    flags &= ~EDGE;
+    bool disagrees = ((flags & FLICKERABLE) != 0) != ((flags & STEADY) != 0);
+    if (disagrees && (currentTime - lastDebounceTime) >= DebounceTime) {
+      flags ^= STEADY | EDGE;
+      if (CountMode == COUNT_BOTH ||
+          (CountMode == COUNT_PRESSES && steadyPressed()) ||
+          (CountMode == COUNT_RELEASES && !steadyPressed()))
+        count++;
+    }
+  }
+
+ private:
+  enum { STEADY = 0x01,        // debounced pin level is HIGH
+         FLICKERABLE = 0x02,   // last raw pin level is HIGH
+         EDGE = 0x04 };        // the debounced level changed during the last loop()
+
+  uint8_t flags;
+  unsigned long lastDebounceTime;
+  unsigned long count;
+
+  // pull-up buttons are pressed when the pin reads LOW, pull-down buttons when it reads HIGH
+  bool steadyPressed(void) const { return ((flags & STEADY) != 0) != PullUp; }
+};
+
+#endif
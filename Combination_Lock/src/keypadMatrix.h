@@ -0,0 +1,193 @@
+/*
+  keypadMatrix.h
+
+  A row/column matrix scanner for keypads, so a 4x4 keypad takes 8 pins instead of 16. Every key
+  is debounced and counted exactly like a button in a buttonGroup, which the scanner is built on:
+  isPressed() and isReleased() are true for the single scan in which a key's debounced state
+  changes, getCount() follows the count mode, and the whole-keypad masks feed buttonGroupEvents and
+  buttonGestures like any other group.
+
+  const uint8_t keypadPins[] = {2, 3, 4, 5,     // rows
+                                A0, A1, A2, A3};  // columns
+  keypadMatrix<4, 4> keypad(keypadPins);
+  keypad.setDebounceTime(20);
+  keypad.setScanInterval(5);  // scan at most every 5 ms, 0 to scan on every call
+
+  keypad.loop();
+  if (keypad.isPressed(keypad.keyIndex(1, 2)))  // key index row * columns + column
+    ...
+
+  The rows are inputs with their pull-ups on and the columns float until they are scanned. A scan
+  pulls one column at a time LOW by setting its bit in the port's data direction register, waits
+  for the lines to settle and reads every row at once, one register read per port the rows use, so
+  rows wired to a single port cost a single read per column. Keys only pull their row LOW while
+  their column is active, so the keypad needs no diodes and no external resistors.
+
+  Without diodes, three keys at the corners of a rectangle make the fourth corner read as pressed
+  too: current flows back through the other three. Such readings are ambiguous, so whenever two
+  rows read two or more of the same columns pressed, the keys in those columns of those rows keep
+  their previous reading until the rectangle is broken. Keys already held stay held, a new key
+  that completes a rectangle is ignored, and ghosted() tells when that happened in the last scan.
+  Keypads with a diode on every key never ghost and lose nothing to the check.
+
+  Up to 8 rows and 8 columns, and up to 32 keys in all.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef keypadMatrix_h
+#define keypadMatrix_h
+
+#include <buttonGroup.h>
+
+// reads a key matrix into a bitmask of levels, bit row * Cols + column LOW while its key is closed
+template <uint8_t Rows, uint8_t Cols>
+class matrixSampler {
+  static_assert(Rows > 0 && Rows <= 8 && Cols > 0 && Cols <= 8,
+                "a keypad has 1 to 8 rows and 1 to 8 columns");
+  static_assert(Rows * Cols <= 32, "a keypad has at most 32 keys");
+
+ public:
+  typedef typename buttonMask<Rows * Cols>::type mask_t;
+
+  matrixSampler() : settleTime(2), ghosting(false) {}
+
+  // the row pins followed by the column pins, rows are read with mode, INPUT_PULLUP
+  void begin(const uint8_t pins[], uint8_t mode) {
+    rows.begin(pins, mode);
+    for (uint8_t c = 0; c < Cols; c++) {
+      uint8_t pin = pins[Rows + c];
+      digitalWrite(pin, LOW);  // driven LOW when active, floating without a pull-up otherwise
+      pinMode(pin, INPUT);
+#ifdef __AVR__
+      uint8_t port = digitalPinToPort(pin);
+      columnMode[c] = port == NOT_A_PIN ? NULL : portModeRegister(port);
+      columnBit[c] = digitalPinToBitMask(pin);
+#else
+      columnPin[c] = pin;
+#endif
+    }
+    for (uint8_t r = 0; r < Rows; r++)
+      lastKeys[r] = 0;
+  }
+
+  mask_t read(void) {
+    // columns of the keys closed in each row
+    uint8_t keys[Rows] = {};
+    for (uint8_t c = 0; c < Cols; c++) {
+      driveColumn(c, true);
+      if (settleTime)
+        delayMicroseconds(settleTime);
+      rowMask_t closed = (rowMask_t)~rows.read() & rowBits;
+      driveColumn(c, false);
+
+      rowMask_t bit = 1;
+      for (uint8_t r = 0; closed; r++, bit <<= 1) {
+        if (closed & bit) {
+          keys[r] |= 1 << c;
+          closed &= ~bit;
+        }
+      }
+    }
+
+    // two rows sharing two or more closed columns could be hiding a ghost, keep the old reading
+    uint8_t ghost[Rows] = {};
+    ghosting = false;
+    for (uint8_t a = 0; a + 1 < Rows; a++) {
+      for (uint8_t b = a + 1; b < Rows; b++) {
+        uint8_t shared = keys[a] & keys[b];
+        if (shared & (shared - 1)) {
+          ghost[a] |= shared;
+          ghost[b] |= shared;
+          ghosting = true;
+        }
+      }
+    }
+
+    mask_t closedKeys = 0;
+    for (uint8_t r = 0; r < Rows; r++) {
+      lastKeys[r] = (keys[r] & ~ghost[r]) | (lastKeys[r] & ghost[r]);
+      closedKeys |= (mask_t)lastKeys[r] << (r * Cols);
+    }
+    return ~closedKeys;
+  }
+
+  // microseconds to wait after activating a column before reading the rows
+  void setSettleTime(uint8_t micros) { settleTime = micros; }
+
+  // the last scan found an ambiguous rectangle of keys
+  bool ghosted(void) const { return ghosting; }
+
+ private:
+  typedef typename buttonMask<Rows>::type rowMask_t;
+  static const rowMask_t rowBits = (rowMask_t)((1 << Rows) - 1);
+
+  portSampler<Rows> rows;
+  uint8_t lastKeys[Rows];  // the accepted reading of each row, a bit per column
+  uint8_t settleTime;
+  bool ghosting;
+#ifdef __AVR__
+  volatile uint8_t *columnMode[Cols];
+  uint8_t columnBit[Cols];
+#else
+  uint8_t columnPin[Cols];
+#endif
+
+  // an active column is an output driving LOW, the others float
+  void driveColumn(uint8_t c, bool active) {
+#ifdef __AVR__
+    if (columnMode[c] == NULL)
+      return;
+    uint8_t oldSREG = SREG;
+    cli();
+    if (active)
+      *columnMode[c] |= columnBit[c];
+    else
+      *columnMode[c] &= ~columnBit[c];
+    SREG = oldSREG;
+#else
+    pinMode(columnPin[c], active ? OUTPUT : INPUT);
+#endif
+  }
+};
+
+template <uint8_t Rows, uint8_t Cols, typename count_t = unsigned long>
+class keypadMatrix : public buttonGroup<Rows * Cols, count_t, matrixSampler<Rows, Cols> > {
+  typedef buttonGroup<Rows * Cols, count_t, matrixSampler<Rows, Cols> > group;
+
+ public:
+  // the row pins followed by the column pins
+  keypadMatrix(const uint8_t pins[]) : group(pins, INPUT_PULLUP, true) {
+    scanInterval = 0;
+    lastScanTime = 0;
+  }
+
+  static uint8_t keyIndex(uint8_t row, uint8_t column) { return row * Cols + column; }
+
+  void setScanInterval(unsigned long interval) { scanInterval = interval; }
+  void setSettleTime(uint8_t micros) { this->sampler.setSettleTime(micros); }
+  bool ghosted(void) const { return this->sampler.ghosted(); }
+
+  void loop(void) { loop(millis()); }
+
+  // calls between scan intervals only clear the previous scan's edges
+  void loop(unsigned long currentTime) {
+    if (currentTime - lastScanTime < scanInterval) {
+      this->commitEdges(0);
+      return;
+    }
+    lastScanTime = currentTime;
+    group::loop(currentTime);
+  }
+
+ private:
+  unsigned long scanInterval;
+  unsigned long lastScanTime;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include <lockConfig.h>
+
+#include <EEPROM.h>
+
+#ifdef __AVR__
+#include <avr/eeprom.h>
+#endif
+
+// settings bytes of a record, between the fingerprint and the checksum
+static const uint8_t settingsSize = lockConfig::recordSize - 2;
+
+// position dependent, like the attempt log's, so shifted or erased bytes don't pass
+static uint8_t checksum(const uint8_t bytes[], uint8_t length) {
+  uint8_t check = 0xC3;
+  for (uint8_t i = 0; i < length; i++)
+    check = (uint8_t)((check << 1) | (check >> 7)) ^ bytes[i];
+  return check;
+}
+
+lockConfig::lockConfig(uint16_t start, const lockSettings &defaults)
+    : start(start), defaults(defaults), current(defaults), unsaved(recordSize) {}
+
+void lockConfig::begin(void) {
+  uint8_t bytes[recordSize];
+  for (uint8_t i = 0; i < recordSize; i++)
+    bytes[i] = EEPROM.read(start + i);
+  if (checksum(bytes, recordSize - 1) != bytes[recordSize - 1])
+    return;
+
+  uint8_t defaultBytes[settingsSize];
+  encode(defaults, defaultBytes);
+  if (bytes[0] != checksum(defaultBytes, settingsSize))
+    return;  // saved under other defaults, the sketch's new ones win
+
+  lockSettings saved;
+  const uint8_t *b = bytes + 1;
+  saved.comboInputTimeOut = b[0] | ((uint16_t)b[1] << 8) | ((uint32_t)b[2] << 16) |
+                            ((uint32_t)b[3] << 24);
+  saved.primingDebounceTime = b[4] | (b[5] << 8);
+  saved.comboDebounceTime = b[6] | (b[7] << 8);
+  saved.lockoutFreeAttempts = b[8];
+  saved.lockoutMaxDoublings = b[9];
+  if (valid(saved))
+    current = saved;
+}
+
+uint32_t lockConfig::get(uint8_t field) const {
+  switch (field) {
+    case CONFIG_COMBO_TIMEOUT:
+      return current.comboInputTimeOut;
+    case CONFIG_PRIMING_DEBOUNCE:
+      return current.primingDebounceTime;
+    case CONFIG_COMBO_DEBOUNCE:
+      return current.comboDebounceTime;
+    case CONFIG_LOCKOUT_FREE_ATTEMPTS:
+      return current.lockoutFreeAttempts;
+    case CONFIG_LOCKOUT_MAX_DOUBLINGS:
+      return current.lockoutMaxDoublings;
+  }
+  return 0;
+}
+
+bool lockConfig::set(uint8_t field, uint32_t value) {
+  lockSettings changed = current;
+  uint32_t widest = 0xFF;
+  switch (field) {
+    case CONFIG_COMBO_TIMEOUT:
+      changed.comboInputTimeOut = value;
+      widest = 0xFFFFFFFF;
+      break;
+    case CONFIG_PRIMING_DEBOUNCE:
+      changed.primingDebounceTime = value;
+      widest = 0xFFFF;
+      break;
+    case CONFIG_COMBO_DEBOUNCE:
+      changed.comboDebounceTime = value;
+      widest = 0xFFFF;
+      break;
+    case CONFIG_LOCKOUT_FREE_ATTEMPTS:
+      changed.lockoutFreeAttempts = value;
+      break;
+    case CONFIG_LOCKOUT_MAX_DOUBLINGS:
+      changed.lockoutMaxDoublings = value;
+      break;
+    default:
+      return false;
+  }
+  if (value > widest || !valid(changed))
+    return false;
+  current = changed;
+  save();
+  return true;
+}
+
+void lockConfig::restoreDefaults(void) {
+  current = defaults;
+  save();
+}
+
+void lockConfig::loop(void) {
+  if (unsaved == recordSize)
+    return;
+#ifdef __AVR__
+  if (!eeprom_is_ready())
+    return;  // the last byte is still being written, don't wait for it
+#endif
+  EEPROM.update(start + unsaved, image[unsaved]);
+  unsaved++;
+}
+
+// the bytes of a record's settings, little-endian
+void lockConfig::encode(const lockSettings &s, uint8_t bytes[]) {
+  bytes[0] = s.comboInputTimeOut;
+  bytes[1] = s.comboInputTimeOut >> 8;
+  bytes[2] = s.comboInputTimeOut >> 16;
+  bytes[3] = s.comboInputTimeOut >> 24;
+  bytes[4] = s.primingDebounceTime;
+  bytes[5] = s.primingDebounceTime >> 8;
+  bytes[6] = s.comboDebounceTime;
+  bytes[7] = s.comboDebounceTime >> 8;
+  bytes[8] = s.lockoutFreeAttempts;
+  bytes[9] = s.lockoutMaxDoublings;
+  bytes[10] = 0;  // spare
+}
+
+// the longest lockout, the timeout doubled lockoutMaxDoublings times, must fit in long: deadlines
+// are compared by the sign of their difference, so a longer one would be due as soon as it is set
+bool lockConfig::valid(const lockSettings &s) {
+  return s.comboInputTimeOut >= 1000 && s.comboInputTimeOut <= 600000UL &&
+         s.primingDebounceTime <= 1000 && s.comboDebounceTime <= 1000 &&
+         s.lockoutFreeAttempts >= 1 && s.lockoutMaxDoublings <= 12 &&
+         s.comboInputTimeOut <= (0x7FFFFFFFUL >> s.lockoutMaxDoublings);
+}
+
+// write the whole record again, the checksum last so a save cut short doesn't pass
+void lockConfig::save(void) {
+  uint8_t defaultBytes[settingsSize];
+  encode(defaults, defaultBytes);
+  image[0] = checksum(defaultBytes, settingsSize);
+  encode(current, image + 1);
+  image[recordSize - 1] = checksum(image, recordSize - 1);
+  unsaved = 0;
+}
@@ -0,0 +1,88 @@
+/*
+  lockConfig.h
+
+  The lock's adjustable settings, kept in EEPROM so they can be changed at runtime (over the serial
+  link, see lockLink.h) instead of by reflashing.
+
+  lockConfig config(512, {10000, 50, 50, 3, 8});  // EEPROM address and the sketch's defaults
+  config.begin();                                  // in setup(), loads saved settings
+  config.set(CONFIG_COMBO_TIMEOUT, 20000);         // checked, applied and saved
+  config.loop();                                   // on every loop, saves a byte at a time
+
+  The settings are saved as one record of recordSize bytes: a fingerprint of the defaults, the
+  settings and a checksum. Saved settings are only used while the defaults compiled into the sketch
+  are the same as when they were saved, so editing a default in the sketch and reflashing still
+  takes effect. A record that fails its checksum, such as one torn by a reset halfway through a
+  save, loads the defaults.
+
+  An EEPROM byte takes about 3.3 ms to write on an AVR, and the EEPROM library waits for the
+  previous write to finish before starting the next one. Saving with loop() writes at most one byte
+  per call and only when the EEPROM is ready, so it never holds up the sketch; a save takes about
+  40 ms. Bytes that already hold their value are skipped.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef lockConfig_h
+#define lockConfig_h
+
+#include <Arduino.h>
+
+struct lockSettings {
+  uint32_t comboInputTimeOut;  // milliseconds
+  uint16_t primingDebounceTime;
+  uint16_t comboDebounceTime;
+  uint8_t lockoutFreeAttempts;
+  uint8_t lockoutMaxDoublings;
+};
+
+enum lockConfigField { CONFIG_COMBO_TIMEOUT,
+                       CONFIG_PRIMING_DEBOUNCE,
+                       CONFIG_COMBO_DEBOUNCE,
+                       CONFIG_LOCKOUT_FREE_ATTEMPTS,
+                       CONFIG_LOCKOUT_MAX_DOUBLINGS,
+                       CONFIG_FIELD_COUNT };
+
+class lockConfig {
+ public:
+  // bytes on the EEPROM
+  static const uint8_t recordSize = 13;
+
+  lockConfig(uint16_t start, const lockSettings &defaults);
+
+  // load the saved settings if they are valid and saved with the same defaults
+  void begin(void);
+
+  const lockSettings &settings(void) const { return current; }
+
+  uint32_t get(uint8_t field) const;
+
+  // change a setting and start saving, false if the field is unknown or the value out of range
+  bool set(uint8_t field, uint32_t value);
+
+  // go back to the defaults and start saving
+  void restoreDefaults(void);
+
+  // save the next byte, if any and the EEPROM is ready
+  void loop(void);
+
+  bool saving(void) const { return unsaved < recordSize; }
+
+ private:
+  uint16_t start;
+  lockSettings defaults;
+  lockSettings current;
+  uint8_t image[recordSize];  // the record being saved
+  uint8_t unsaved;            // index of the next byte of image to save, recordSize when saved
+
+  static void encode(const lockSettings &s, uint8_t bytes[]);
+  static bool valid(const lockSettings &s);
+  void save(void);
+};
+
+#endif
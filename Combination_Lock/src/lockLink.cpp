@@ -0,0 +1,151 @@
+#include <lockLink.h>
+
+#ifdef LOCK_LINK
+
+static lockConfig *settings;
+static lockLink::telemetryWriter sketchTelemetry;
+static lockLink::settingsApplier applySettings;
+
+// loop timing since the last telemetry request
+static uint32_t passes;
+static uint32_t passTime;
+static uint32_t longestPass;
+
+// bytes of each reply's data beyond its command, tag and status
+static const uint8_t replyHeader = 3;
+static const uint8_t settingsReply = 1 + 4 * CONFIG_FIELD_COUNT;
+
+void lockLink::begin(lockConfig &config, telemetryWriter telemetry, settingsApplier apply) {
+  settings = &config;
+  sketchTelemetry = telemetry;
+  applySettings = apply;
+  frameLink::begin(LINK_BAUD);
+}
+
+void lockLink::recordPass(uint32_t elapsed) {
+  passes++;
+  passTime += elapsed;
+  if (elapsed > longestPass)
+    longestPass = elapsed;
+}
+
+static void putSettings(frameWriter &reply) {
+  reply.put(CONFIG_FIELD_COUNT);
+  for (uint8_t field = 0; field < CONFIG_FIELD_COUNT; field++)
+    reply.put32(settings->get(field));
+}
+
+static void putTelemetry(frameWriter &reply, uint8_t firstButton) {
+  reply.put32(millis());
+  reply.put32(passes);
+  reply.put32(passTime);
+  reply.put32(longestPass);
+  passes = 0;
+  passTime = 0;
+  longestPass = 0;
+
+  frameLinkStats link = frameLink::stats();
+  reply.put16(link.frames);
+  reply.put16(link.badFrames);
+  reply.put16(link.overruns);
+  if (sketchTelemetry != NULL)
+    sketchTelemetry(reply, firstButton);
+}
+
+// the room a reply needs, so a reply that doesn't fit yet can wait without being started
+static uint8_t replySize(uint8_t command, uint8_t requestLength) {
+  switch (command) {
+    case LINK_PING:
+      return replyHeader + requestLength - 2;
+    case LINK_GET_SETTINGS:
+    case LINK_RESTORE_DEFAULTS:
+      return replyHeader + settingsReply;
+    case LINK_SET_SETTING:
+      return replyHeader + 4;
+    case LINK_TELEMETRY:
+      return frameMaxTxPayload;  // whatever fits, the sketch's part may be long
+  }
+  return replyHeader;
+}
+
+// a reply with only a status, false when there is no room for it yet
+static bool refuse(const frameView &request, uint8_t status) {
+  frameWriter reply(replyHeader);
+  if (!reply.ready())
+    return false;
+  reply.put(request[0] | linkReplyFlag);
+  reply.put(request[1]);
+  reply.put(status);
+  return reply.send();
+}
+
+// false when there is no room for the reply yet
+static bool answer(const frameView &request) {
+  if (request.length() < 2)
+    return true;  // without a tag there is nothing to reply to
+  uint8_t command = request[0];
+  uint8_t arguments = request.length() - 2;
+
+  uint8_t size = replySize(command, request.length());
+  if (size <= frameMaxTxPayload) {
+    frameWriter reply(size);
+    if (!reply.ready())
+      return false;
+    reply.put(command | linkReplyFlag);
+    reply.put(request[1]);
+
+    switch (command) {
+      case LINK_PING:
+        reply.put(LINK_DONE);
+        for (uint8_t i = 0; i < arguments; i++)
+          reply.put(request[2 + i]);
+        break;
+      case LINK_TELEMETRY:
+        reply.put(LINK_DONE);
+        putTelemetry(reply, arguments >= 1 ? request[2] : 0);
+        break;
+      case LINK_GET_SETTINGS:
+        reply.put(LINK_DONE);
+        putSettings(reply);
+        break;
+      case LINK_SET_SETTING:
+        if (arguments < 5) {
+          reply.put(LINK_MISSING_ARGUMENTS);
+        } else if (!settings->set(request[2], request.u32(3))) {
+          reply.put(LINK_BAD_SETTING);
+        } else {
+          reply.put(LINK_DONE);
+          reply.put32(settings->get(request[2]));
+          if (applySettings != NULL)
+            applySettings();
+        }
+        break;
+      case LINK_RESTORE_DEFAULTS:
+        settings->restoreDefaults();
+        if (applySettings != NULL)
+          applySettings();
+        reply.put(LINK_DONE);
+        putSettings(reply);
+        break;
+      default:
+        reply.put(LINK_UNKNOWN_COMMAND);
+        break;
+    }
+    if (reply.send())
+      return true;
+  }
+  // nothing of a reply that overflowed was sent
+  return refuse(request, LINK_REPLY_TOO_LONG);
+}
+
+void lockLink::loop(void) {
+  settings->loop();
+  frameView request;
+  while (frameLink::receive(request)) {
+    if (!answer(request))
+      return;  // try again on a later pass
+    frameLink::release();
+  }
+}
+
+#endif
@@ -0,0 +1,132 @@
+/*
+  lockLink.h
+
+  Opt-in command and telemetry channel over the serial port, built on the frames of frameLink.h.
+  Build with -D LOCK_LINK (the uno_link and native_link environments do) to read the lock's state,
+  counters and loop timing and to change its settings (lockConfig.h) without reflashing. Without
+  the flag the macros expand to nothing and the UART is left alone.
+
+  void setup() {
+    LINK_BEGIN(config, writeTelemetry, applySettings);
+  }
+
+  void loop() {
+    {
+      LINK_TIME_PASS();
+      ...
+    }
+    LINK_LOOP();
+  }
+
+  Requests and replies are frame payloads. A request is a command byte, a tag byte chosen by the
+  host and the command's arguments; its reply is the command byte with the top bit set, the same
+  tag, a status byte and the reply's data. Values are little-endian.
+
+  command              arguments              reply data
+  0x01 ping            any bytes              the same bytes
+  0x02 telemetry       first button           link and loop figures, then the sketch's own
+  0x03 get settings                           field count, then each setting as 4 bytes
+  0x04 set setting     field, 4 byte value    the setting as saved
+  0x05 restore defaults                       field count, then each setting as 4 bytes
+
+  The link's telemetry is the uptime in milliseconds, the passes of the loop, their total and
+  longest time in microseconds since the previous telemetry request (4 bytes each), and the frames
+  received, bad frames and receive overruns (2 bytes each). The sketch's telemetry callback follows
+  with whatever it adds, such as button counts from the given first button on for as many as fit.
+  On the native build micros() doesn't move within a pass of the loop, so pass times read zero.
+
+  Status is 0 for done, 1 for an unknown command, 2 for missing arguments, 3 for a setting that is
+  unknown or out of range and 4 for a reply too long for a frame. Settings that change are saved to
+  EEPROM a byte per pass of the loop and handed to the sketch's callback to apply.
+
+  Each pass of LINK_LOOP() answers every complete request that has arrived. A request whose reply
+  doesn't fit in the transmit ring yet waits in the receive ring for a later pass, so nothing in the
+  loop waits on the UART. The link needs the UART running, so the sketch mustn't power down while
+  it is on; idle sleep is woken by received bytes.
+
+  On AVR boards the link takes over the UART from Serial, so it can't be combined with LOCK_PROFILE
+  or LOCK_RAM_REPORT there. It runs at LINK_BAUD (115200 unless defined otherwise).
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef lockLink_h
+#define lockLink_h
+
+#include <Arduino.h>
+#include <lockConfig.h>
+
+#ifdef LOCK_LINK
+
+#include <frameLink.h>
+
+#if defined(__AVR__) && (defined(LOCK_PROFILE) || defined(LOCK_RAM_REPORT))
+#error "LOCK_LINK takes over the UART and can't be combined with LOCK_PROFILE or LOCK_RAM_REPORT"
+#endif
+
+#ifndef LINK_BAUD
+#define LINK_BAUD 115200
+#endif
+
+enum linkCommand { LINK_PING = 1,
+                   LINK_TELEMETRY,
+                   LINK_GET_SETTINGS,
+                   LINK_SET_SETTING,
+                   LINK_RESTORE_DEFAULTS };
+
+enum linkStatus { LINK_DONE,
+                  LINK_UNKNOWN_COMMAND,
+                  LINK_MISSING_ARGUMENTS,
+                  LINK_BAD_SETTING,
+                  LINK_REPLY_TOO_LONG };
+
+const uint8_t linkReplyFlag = 0x80;
+
+namespace lockLink {
+
+// adds the sketch's telemetry to a reply, starting its button counts from firstButton
+typedef void (*telemetryWriter)(frameWriter &out, uint8_t firstButton);
+
+// the settings have changed and should be applied
+typedef void (*settingsApplier)(void);
+
+void begin(lockConfig &config, telemetryWriter telemetry, settingsApplier apply);
+
+// answer the requests that have arrived and save changed settings
+void loop(void);
+
+void recordPass(uint32_t elapsed);
+
+}  // namespace lockLink
+
+class linkPassTimer {
+ public:
+  linkPassTimer() : start(micros()) {}
+  ~linkPassTimer() { lockLink::recordPass(micros() - start); }
+
+ private:
+  uint32_t start;
+};
+
+const bool linkActive = true;
+
+#define LINK_BEGIN(config, telemetry, apply) lockLink::begin(config, telemetry, apply)
+#define LINK_TIME_PASS() linkPassTimer linkPass
+#define LINK_LOOP() lockLink::loop()
+
+#else
+
+const bool linkActive = false;
+
+#define LINK_BEGIN(config, telemetry, apply)
+#define LINK_TIME_PASS()
+#define LINK_LOOP()
+
+#endif
+
+#endif
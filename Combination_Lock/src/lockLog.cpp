@@ -0,0 +1,132 @@
+#include <lockLog.h>
+
+#include <EEPROM.h>
+
+const uint8_t noEvent = 0xFF;
+
+// position dependent, so swapped or shifted bytes don't pass, and an erased slot fails it
+static uint8_t checksum(const uint8_t bytes[], uint8_t length) {
+  uint8_t check = 0x5A;
+  for (uint8_t i = 0; i < length; i++)
+    check = (uint8_t)((check << 1) | (check >> 7)) ^ bytes[i];
+  return check;
+}
+
+lockLog::lockLog(uint16_t start, uint16_t length) : start(start) {
+  uint16_t count = length / recordSize;
+  slots = count < 255 ? count : 255;
+  next = 0;
+  hasRecords = false;
+  pending = false;
+  batching = false;
+  memset(&state, 0, sizeof(state));
+  state.event = noEvent;
+}
+
+void lockLog::begin(void) {
+  if (slots < 2)
+    return;
+
+  // the newest record is the last of the run of consecutive sequence numbers starting at slot 0
+  lockLogRecord first;
+  uint8_t latest;
+  if (readSlot(0, first)) {
+    uint8_t low = 0;
+    uint8_t high = slots - 1;
+    while (low < high) {
+      uint8_t middle = low + (high - low + 1) / 2;
+      lockLogRecord record;
+      if (readSlot(middle, record) && record.sequence == (uint16_t)(first.sequence + middle))
+        low = middle;
+      else
+        high = middle - 1;
+    }
+    latest = low;
+  } else if (readSlot(slots - 1, first)) {
+    latest = slots - 1;  // slot 0 was being rewritten when the board reset
+  } else {
+    return;  // nothing logged yet
+  }
+
+  readSlot(latest, state);
+  next = latest + 1 == slots ? 0 : latest + 1;
+  hasRecords = true;
+}
+
+void lockLog::recordFailure(void) {
+  if (state.failures < 0xFF)
+    state.failures++;
+  if (state.attempts < 0xFFFF)
+    state.attempts++;
+  if (batching) {
+    pending = true;
+    return;
+  }
+  append(LOG_FAILURE);
+  batching = true;
+}
+
+void lockLog::recordSuccess(void) {
+  state.failures = 0;
+  if (state.successes < 0xFFFF)
+    state.successes++;
+  append(LOG_SUCCESS);
+}
+
+void lockLog::recordLockout(bool started) {
+  append(started ? LOG_LOCKOUT_STARTED : LOG_LOCKOUT_ENDED);
+}
+
+void lockLog::flush(void) {
+  if (pending)
+    append(LOG_FAILURE);
+  batching = false;
+}
+
+bool lockLog::read(uint8_t back, lockLogRecord &record) const {
+  if (!hasRecords || back >= slots)
+    return false;
+  uint8_t latest = next == 0 ? slots - 1 : next - 1;
+  uint8_t slot = latest >= back ? latest - back : latest + slots - back;
+  // slots not yet written, or torn, are the end of the log
+  return readSlot(slot, record) && record.sequence == (uint16_t)(state.sequence - back);
+}
+
+bool lockLog::readSlot(uint8_t slot, lockLogRecord &record) const {
+  uint8_t bytes[recordSize];
+  uint16_t address = start + (uint16_t)slot * recordSize;
+  for (uint8_t i = 0; i < recordSize; i++)
+    bytes[i] = EEPROM.read(address + i);
+  if (checksum(bytes, recordSize - 1) != bytes[recordSize - 1])
+    return false;
+
+  record.sequence = bytes[0] | (bytes[1] << 8);
+  record.event = bytes[2];
+  record.failures = bytes[3];
+  record.attempts = bytes[4] | (bytes[5] << 8);
+  record.successes = bytes[6] | (bytes[7] << 8);
+  return true;
+}
+
+// write the counters as the next record, the checksum last so an interrupted write won't pass
+void lockLog::append(uint8_t event) {
+  if (slots < 2)
+    return;
+  state.sequence = hasRecords ? state.sequence + 1 : 0;
+  state.event = event;
+
+  uint8_t bytes[recordSize] = {
+      (uint8_t)state.sequence, (uint8_t)(state.sequence >> 8),  state.event,
+      state.failures,          (uint8_t)state.attempts,         (uint8_t)(state.attempts >> 8),
+      (uint8_t)state.successes, (uint8_t)(state.successes >> 8), 0};
+  bytes[recordSize - 1] = checksum(bytes, recordSize - 1);
+
+  uint16_t address = start + (uint16_t)next * recordSize;
+  for (uint8_t i = 0; i < recordSize; i++)
+    EEPROM.update(address + i, bytes[i]);
+
+  next = next + 1 == slots ? 0 : next + 1;
+  hasRecords = true;
+  pending = false;
+  batching = false;
+}
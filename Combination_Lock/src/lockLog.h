@@ -0,0 +1,99 @@
+/*
+  lockLog.h
+
+  A persistent log of the lock's attempts, successes and lockouts, kept in EEPROM so neither the
+  count of wrong combos nor a lockout can be cleared by resetting the board, and so the last few
+  hundred events can be read back as an audit trail.
+
+  lockLog history(0, 512);  // EEPROM bytes 0 to 511
+  history.begin();          // in setup(), restores the counters
+  history.recordFailure();  // a wrong combo
+  history.recordSuccess();  // a right one, clears the failure count
+  history.flush();          // write failures held back, e.g. when the input window closes
+
+  Every record is a snapshot of the counters plus the event that produced it, under a sequence
+  number that grows by one per record, so the latest record alone restores the state. Records are
+  written round-robin over the whole region, which spreads wear evenly: a 512 byte region holds 56
+  records, so each cell is written once every 56 records and the 100,000 write cycles of an AVR
+  EEPROM cell last for over five million records. Bytes are written with EEPROM.update(), which
+  skips bytes that already hold the value.
+
+  At startup the latest record is found with a binary search instead of a scan. Slots written in
+  the current pass around the ring follow each other's sequence numbers, so the search looks for the
+  last slot whose sequence number is slot 0's plus its distance from slot 0, reading about log2 of
+  the slot count records. A checksum rejects erased slots and records torn by a reset halfway
+  through a write, so a torn record leaves the one before it as the latest.
+
+  Failures are batched: the first failure after a flush is written straight away, later ones are
+  counted in RAM and written with the next record, so a burst of wrong combos within one input
+  window costs one or two writes instead of one each. Successes and lockouts are written at once.
+  Since every boot's first failure reaches the EEPROM, resetting the board between attempts still
+  builds up the failure count.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef lockLog_h
+#define lockLog_h
+
+#include <Arduino.h>
+
+enum lockLogEvent { LOG_FAILURE,
+                    LOG_SUCCESS,
+                    LOG_LOCKOUT_STARTED,
+                    LOG_LOCKOUT_ENDED };
+
+struct lockLogRecord {
+  uint16_t sequence;
+  uint8_t event;      // a lockLogEvent
+  uint8_t failures;   // wrong combos since the last success, saturates at 255
+  uint16_t attempts;  // wrong combos ever, saturates at 65535
+  uint16_t successes;
+};
+
+class lockLog {
+ public:
+  // bytes on the EEPROM, kept in records of recordSize bytes
+  static const uint8_t recordSize = 9;
+
+  lockLog(uint16_t start, uint16_t length);
+
+  // find the latest record and restore the counters from it
+  void begin(void);
+
+  void recordFailure(void);
+  void recordSuccess(void);
+  void recordLockout(bool started);
+
+  // write failures counted since the last record
+  void flush(void);
+
+  uint8_t failures(void) const { return state.failures; }
+  uint16_t attempts(void) const { return state.attempts; }
+  uint16_t successes(void) const { return state.successes; }
+
+  // the latest record started a lockout that hasn't ended
+  bool lockedOut(void) const { return state.event == LOG_LOCKOUT_STARTED; }
+
+  // the record back records before the latest, false once past the oldest one kept
+  bool read(uint8_t back, lockLogRecord &record) const;
+
+ private:
+  uint16_t start;
+  uint8_t slots;
+  uint8_t next;  // slot the next record goes to
+  bool hasRecords;
+  bool pending;   // failures counted in RAM only
+  bool batching;  // a failure has been written since the last record of another kind or flush
+  lockLogRecord state;  // the counters, and the sequence number and event of the latest record
+
+  bool readSlot(uint8_t slot, lockLogRecord &record) const;
+  void append(uint8_t event);
+};
+
+#endif
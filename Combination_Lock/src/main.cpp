@@ -13,14 +13,17 @@
   - Primed...........The blue LED will turn off and the system is now listening for combo buttons.
                      If a full length combo is entered, the primed state will check if it's correct.
                      If the timeout is reached, the system will return to an unprimed state.
-  - Correct Combo....Turn on the green LED and the accessory circuit.
+  - Correct Combo....Turn on the green LED and the accessory circuit of the combo entered.
                      If the system was flashing red from a previous incorrect input, stop flashing.
   - Incorrect Combo..Tell the system to begin flashing red on next loop.
-                     Re-prime the system for additional attemps within the timeout window.
+                     Re-prime the system for additional attemps within the timeout window, or lock
+                     the system out after too many incorrect combos in a row.
+  - Locked Out.......The red LED breathes and the priming button is ignored until the lockout
+                     time has passed, then the system returns to the not primed state.
 
   In addition to the primary system states, the system is always listening for the priming button
   and managing the state of the red LED. From any state, if the priming button is pressed the input
-  timer is reset, the combo input index is reset to zero, and the system is set to the primed state
+  timer is reset, the combo entered so far is forgotten, and the system is set to the primed state
   to allow new combo attemps. From the correct combo state, the priming button also acts as a reset
   button to turn off the accessory circuit. Note: after reseting the system, it is immediately
   prepared to accept new combo input until the timeout is reached. If you want to turn off the
@@ -32,6 +35,31 @@
   combo attempt, they may immediately try a new combo and if they get it right, the red flashing
   will be halted as the green LED and accessory are turned on.
 
+  Any number of combos can be stored, for example one per user, and each one switches on its own
+  accessory output; with a single accessory pin they all share it. Combo presses aren't buffered.
+  Each press advances an automaton built from all the combos at compile time and stored in flash
+  (see comboSet.h), so checking a press costs one table lookup however many combos there are and
+  however long they are. In block mode, the default, presses are accepted as soon as they spell a
+  combo and rejected once as many presses as the longest combo has were made without one. In
+  rolling mode the lock opens as soon as the last presses spell a combo, and wrong presses are never
+  reported.
+
+  Every attempt is logged in EEPROM (see lockLog.h), so the count of incorrect combos in a row and
+  an ongoing lockout survive a reset or power loss; a lockout interrupted by a reset starts over.
+  After lockoutFreeAttempts incorrect combos in a row every further one locks the system out, for
+  the combo input timeout at first and twice as long with each incorrect combo after that, until a
+  correct combo clears the count. Only block mode rejects combos, so rolling mode never locks out.
+
+  Combos can also be entered as chords, pressing several combo buttons together, which gives more
+  combo symbols than there are buttons (see comboChords below and buttonGestures.h).
+
+  The lock itself, its states, timers and red LED, is a combinationLock (see combinationLock.h)
+  that is handed the scanned buttons and the time and hands back its outputs, so the same board can
+  run several independent locks. Each state is a row of a table listing the outputs it drives and
+  its entry, update and exit actions. Outputs are only written when they change, and the pins that
+  share a port are written together, so a pass of the loop that changes nothing costs no pin writes
+  at all.
+
   User defined settings in the global scope:
   - digital pin for the accessory circuit
   - digital pins for the green, red, and blue LEDs
@@ -39,8 +67,9 @@
   - debounce time for the priming button
   - digital pins for the combo buttons
   - debounce time for the combo buttons
-  - lock combo
+  - lock combos, the accessory each one switches on, and how presses are matched against them
   - combo input timeout in milliseconds
+  - lockout after incorrect combos, and where in EEPROM the attempts are logged
   - red flash characteristics after an incorrect combo is entered
 
   The circuit:
@@ -66,8 +95,27 @@
   series resistor pull the voltage level down, meaning it always returns LOW. If you must use pin
   13 as a digital input, set its pin mode to INPUT and use an external pull-down resistor.
 
+  The combo input timeout and the lockout are one-shot tasks of a cooperativeScheduler, which tells
+  the loop whether anything is due so it can idle between the timer interrupts that keep millis()
+  running. The red LED is flashed by a pattern played from a timer interrupt, so the loop only
+  starts and stops it. While the system is not primed and nothing is flashing, the board powers
+  down completely and is woken by a pin change on the priming button, which is watched by interrupt
+  for that reason.
+
+  Building with -D LOCK_PROFILE times the button scans, the lock's update and the whole pass of
+  the loop; send 'p' over Serial for the statistics (see profiler.h).
+  Building with -D LOCK_RAM_REPORT prints the RAM taken by each of the sketch's objects at startup
+  (see ramReport.h).
+  Building with -D LOCK_LINK opens a binary command channel on the serial port (see lockLink.h) to
+  read the state, counters and loop timing, and to change the combo input timeout, the debounce
+  times and the lockout without reflashing. Changed settings are kept in EEPROM (see lockConfig.h)
+  and the board idles instead of powering down, so it can keep listening.
+
   Dependencies:
-  - button library
+  - button library (button.h and buttonGroup.h)
+  - cooperativeScheduler, ledPatterns and frameLink libraries from the libraries folder of this
+    sketchbook
+  - EEPROM library that comes with the Arduino core
 
   created 27 Nov 2022
   by Beaker406
@@ -79,6 +127,19 @@
 
 // #include <Arduino.h>  // comment this line out if using the Arduino IDE
 #include <button.h>
+#include <buttonGestures.h>
+#include <buttonGroup.h>
+#include <combinationLock.h>
+#include <comboSet.h>
+#include <cooperativeScheduler.h>
+#include <ledPatterns.h>
+#include <lockConfig.h>
+#include <lockLink.h>
+#include <lockLog.h>
+#include <outputGroup.h>
+#include <powerDown.h>
+#include <profiler.h>
+#include <ramReport.h>
 
 // tl;dr only make changes to numerical constants
 //       leave any computed or derived variables alone
@@ -89,180 +150,194 @@ const int GREEN_LED_PIN = 5;
 const int RED_LED_PIN = 6;
 const int BLUE_LED_PIN = 7;
 
+// outputs are only written when they change, pins sharing a port are written together
+// the lock's outputs come in this order, its accessories then the green and blue LEDs, so more
+// accessories can be added before GREEN_LED in both lists; the red LED is driven by the LED pattern
+// engine instead
+const uint8_t outputPins[] = {ACCESSORY_PIN, GREEN_LED_PIN, BLUE_LED_PIN};
+enum outputIndex { ACCESSORY,
+                   GREEN_LED,
+                   BLUE_LED };
+const int outputsCount = sizeof(outputPins);
+outputGroup<outputsCount> outputs(outputPins);
+
 // set primer button pin and debounce time here
 const int primingButtonPin = 8;
 const unsigned long primingButtonDebounceTime = 50;
 button primingButton(primingButtonPin, INPUT, false);
+buttonEventBuffer<4> primingEvents;  // presses are queued, so none are lost while loop() is blocked
 
-// set combo button pins and their debounce time here (expand past 3 if desired)
-const int comboButtonPins[] = {9, 10, 11};
+// set combo button pins and their debounce time here (expand past 3 if desired, up to 32)
+const uint8_t comboButtonPins[] = {9, 10, 11};
 const unsigned long comboButtonsDebounceTime = 50;
-const int comboButtonsCount = sizeof(comboButtonPins) / sizeof(int);
-button comboButtons[comboButtonsCount] = {};
-
-// set a lock combo of any length here
-const int lockCombo[] = {0, 1, 2};
-const int lockComboLength = sizeof(lockCombo) / sizeof(int);
-int comboInput[lockComboLength] = {};
-int comboInputIndex;
+const int comboButtonsCount = sizeof(comboButtonPins);
+// verticalButtonGroup from verticalCounter.h takes the same arguments with a bit-parallel debouncer
+// that saves RAM but misses or invents the odd press, and keypadMatrix from keypadMatrix.h scans a
+// keypad, e.g. 16 keys on 8 pins with keypadMatrix<4, 4> comboButtons(keypadPins) and
+// comboButtonsCount set to 16
+buttonGroup<comboButtonsCount> comboButtons(comboButtonPins, INPUT, false);
+
+// set true to enter combos as chords of buttons pressed together (up to 8 buttons), each counted
+// when all its buttons are released; 3 buttons then give 7 combo symbols: 0 to 2 for the single
+// buttons, 3 for buttons 0 and 1, 4 for 0 and 2, 5 for 1 and 2, and 6 for all three
+const bool comboChords = false;
+const int comboSymbols =
+    comboChords ? buttonGestures<comboChords ? comboButtonsCount : 1>::symbols : comboButtonsCount;
+
+// set the lock combos here, as many as needed and each of any length up to 255 presses, every one
+// followed by the accessory it switches on, e.g. 2, 2, 1, 0, comboAction(ACCESSORY),
+// in block mode no combo may start with another whole combo; set COMBO_ROLLING to match the last
+// presses instead
+constexpr uint8_t lockCombos[] = {
+    0, 1, 2, comboAction(ACCESSORY),
+};
+const comboMatchMode lockComboMode = COMBO_BLOCK;
+typedef comboSet<comboSymbols, comboSetNodes<comboSymbols>(lockCombos)> lockComboSet;
+constexpr lockComboSet lockComboTable PROGMEM = lockComboSet(lockCombos);
 
 // set the amount of time in milliseconds the user has to input the combo
 const unsigned long comboInputTimeOut = 10000;
-unsigned long comboInputStartMillis;
+
+// set the lockout here: incorrect combos in a row allowed before locking out, and how many times
+// the lockout may double from the combo input timeout (10 s, 20 s, 40 s, ... 8 doublings is 43 min)
+const uint8_t lockoutFreeAttempts = 3;
+const uint8_t lockoutMaxDoublings = 8;
+
+// set the EEPROM bytes the attempts are logged in, 9 bytes per record, more records spread the wear
+lockLog attemptLog(0, 512);
+
+// the timeout, debounce times and lockout above are defaults that can be changed at runtime over
+// the serial link; changes are kept in the EEPROM bytes after the log
+lockConfig config(512, {comboInputTimeOut, primingButtonDebounceTime, comboButtonsDebounceTime,
+                        lockoutFreeAttempts, lockoutMaxDoublings});
 
 // set flash red characteristics
 // total flashing time = count * interval * 2
 const int flashRedCount = 5;         // number of times to flash the red LED
 const long toggleRedInterval = 100;  // milliseconds LED is on for and then off for
-const int toggleRedCount = flashRedCount * 2;
-bool flashRed = false;
-int toggleRedIndex;
-unsigned long lastToggleRedMillis = millis();
-
-// enumerate possible states and initialize the system
-enum systemState { NOT_PRIMED,
-                   PRIMED,
-                   CORRECT_COMBO,
-                   INCORRECT_COMBO };
-int currentSystemState = NOT_PRIMED;
+// played by a timer interrupt (see ledPatterns.h), so the flashing keeps exact time however busy
+// the loop is
+const ledPattern flashRedPattern PROGMEM = {ledBlinkLevels, 2, toggleRedInterval};
+
+// the lock's timers, one scheduler for every lock of the sketch with room for lockTasks each
+lockScheduler lockTimers;
+
+// the lock, with as many accessories as there are outputs before the LEDs
+combinationLock<lockComboSet, comboButtonsCount, GREEN_LED, comboChords> lock(
+    lockComboTable, lockComboMode, config.settings(), attemptLog, lockTimers, flashRedCount,
+    toggleRedInterval);
+
+#ifdef LOCK_PROFILE
+enum profileSection { PROFILE_LOOP,
+                      PROFILE_PRIMING_SCAN,
+                      PROFILE_COMBO_SCAN,
+                      PROFILE_LOCK_UPDATE,
+                      PROFILE_SECTION_COUNT };
+const char *const profileSectionNames[PROFILE_SECTION_COUNT] = {"loop", "priming scan",
+                                                                "combo scan", "lock update"};
+#endif
 
 // forward declarations of functions
-bool isTimedOut(unsigned long startTime, unsigned long timeOut);
-bool compareArrays(const int arrayA[], const int arrayB[], const int length);
+void applySettings(void);
+#ifdef LOCK_LINK
+void writeTelemetry(frameWriter &out, uint8_t firstButton);
+#endif
 
 void setup() {
-  pinMode(ACCESSORY_PIN, OUTPUT);
-  pinMode(GREEN_LED_PIN, OUTPUT);
-  pinMode(RED_LED_PIN, OUTPUT);
-  pinMode(BLUE_LED_PIN, OUTPUT);
-
-  primingButton.setDebounceTime(primingButtonDebounceTime);
-
-  // initialize combo buttons within buttons array
-  for (int i = 0; i < comboButtonsCount; i++) {
-    comboButtons[i] = button(comboButtonPins[i], INPUT, false);
-    comboButtons[i].setDebounceTime(comboButtonsDebounceTime);
-  }
+  config.begin();
+  applySettings();
+  primingButton.enableInterrupts();  // catch priming presses while loop() is blocked or asleep
+  primingButton.attachEvents(primingEvents);
+  lock.attachRedLed(ledPatterns::attach(RED_LED_PIN), &flashRedPattern);
+  PROFILE_BEGIN();
+  LINK_BEGIN(config, writeTelemetry, applySettings);
+
+  // restore the attempt counters, and resume a lockout the board was reset during
+  attemptLog.begin();
+  lock.begin(millis());
+
+  // the outputs start LOW, drive them for the initial state
+  outputs.write(lock.outputs());
+
+  RAM_REPORT_BEGIN();
+  RAM_REPORT(outputs);
+  RAM_REPORT(primingButton);
+  RAM_REPORT(primingEvents);
+  RAM_REPORT(comboButtons);
+  RAM_REPORT(lock);
+  RAM_REPORT(lockTimers);
+  RAM_REPORT(attemptLog);
+  RAM_REPORT(config);
+  RAM_REPORT_END();
 }  // end setup
 
 void loop() {
-  // always monitor the primer button regardless of the current system state
-  primingButton.loop();
-  if (primingButton.isPressed()) {
-    currentSystemState = PRIMED;
-    comboInputIndex = 0;
-    comboInputStartMillis = millis();
-  }
+  {
+    PROFILE_SCOPE(PROFILE_LOOP);
+    LINK_TIME_PASS();
+    unsigned long currentMillis = millis();
+
+    // always monitor the primer button regardless of the current system state
+    {
+      PROFILE_SCOPE(PROFILE_PRIMING_SCAN);
+      primingButton.loop();
+    }
+    // isPressed() only reports the last edge of a scan, the queue has every press
+    buttonEvent event;
+    while (primingEvents.pop(event)) {
+      if (event.type == BUTTON_PRESS)
+        lock.prime(currentMillis);  // (re)start the combo input window, unless locked out
+    }
 
-  // after an incorrect combo, flash red without blocking continued execution
-  if (flashRed) {
-    if (toggleRedIndex < toggleRedCount) {
-      if (millis() - lastToggleRedMillis >= toggleRedInterval) {
-        digitalWrite(RED_LED_PIN, !digitalRead(RED_LED_PIN));
-        lastToggleRedMillis = millis();
-        toggleRedIndex++;
-      }
-    } else {
-      flashRed = false;
-      toggleRedIndex = 0;
+    // the combo buttons are only read while the lock listens to them
+    if (lock.listening()) {
+      PROFILE_SCOPE(PROFILE_COMBO_SCAN);
+      comboButtons.loop(currentMillis);
     }
-  }
 
-  // run current system state specific code
-  switch (currentSystemState) {
-    case NOT_PRIMED: {
-      // set pin states and continue to wait for primer button
-      digitalWrite(ACCESSORY_PIN, LOW);
-      digitalWrite(GREEN_LED_PIN, LOW);
-      digitalWrite(BLUE_LED_PIN, HIGH);
-
-      break;
-    }  // end case NOT_PRIMED
-
-    case PRIMED: {
-      // set pin states
-      digitalWrite(ACCESSORY_PIN, LOW);
-      digitalWrite(GREEN_LED_PIN, LOW);
-      digitalWrite(BLUE_LED_PIN, LOW);
-
-      // check each combo button for a press
-      for (int i = 0; i < comboButtonsCount; i++) {
-        comboButtons[i].loop();
-        if (comboButtons[i].isPressed()) {
-          comboButtons[i].loop();  // loop after pressed ensures hung state is cleared
-
-          comboInput[comboInputIndex] = i;  // store index of pressed button
-          comboInputIndex++;                // and increase input index for next pressed button
-        }
-      }
-
-      // full code entered, evaluate it and set system state for next run
-      if (lockComboLength == comboInputIndex) {
-        if (compareArrays(lockCombo, comboInput, lockComboLength))
-          currentSystemState = CORRECT_COMBO;
-        else
-          currentSystemState = INCORRECT_COMBO;
-      }
-
-      // monitor combo intput timeout status, reset system state after timeout
-      if (isTimedOut(comboInputStartMillis, comboInputTimeOut))
-        currentSystemState = NOT_PRIMED;
-
-      break;
-    }  // end case PRIMED
-
-    case CORRECT_COMBO: {
-      // set pin states
-      digitalWrite(ACCESSORY_PIN, HIGH);
-      digitalWrite(GREEN_LED_PIN, HIGH);
-      digitalWrite(RED_LED_PIN, LOW);
-      digitalWrite(BLUE_LED_PIN, LOW);
-
-      // stop flashing red if correct combo was entered after
-      // an incorrect attempt but before flashing completed
-      flashRed = false;
-
-      break;
-    }  // end case CORRECT_COMBO
-
-    case INCORRECT_COMBO: {
-      // prepare to flash the red LED
-      flashRed = true;
-      toggleRedIndex = 0;
-
-      // re-prime the system for additional attempts within the input window
-      currentSystemState = PRIMED;
-      comboInputIndex = 0;
-
-      break;
-    }  // end case INCORRECT_COMBO
-
-    default: {
-      // this should never ever execute but exists anyways just in case
-      digitalWrite(GREEN_LED_PIN, HIGH);
-      digitalWrite(RED_LED_PIN, HIGH);
-      digitalWrite(BLUE_LED_PIN, HIGH);
-      delay(10000);
-      break;
-    }  // end case default
-  }    // end switch
+    // run the lock's timers and its current state, then drive the outputs it asks for
+    {
+      PROFILE_SCOPE(PROFILE_LOCK_UPDATE);
+      lock.update(currentMillis, comboButtons.pressedMask(), comboButtons.heldMask());
+    }
+    outputs.write(lock.outputs());
+  }
+  PROFILE_DUMP_ON_REQUEST(profileSectionNames);
+  LINK_LOOP();
+
+  // nothing can happen before the next priming press when unprimed and not flashing, so power down
+  // until the priming button wakes the board; otherwise idle until the next interrupt unless a timer
+  // is due, which keeps millis() running and polls the combo buttons at least once a millisecond;
+  // the serial link needs the UART awake, so it only ever idles
+  if (!linkActive && lock.idle() && !ledPatterns::busy())
+    powerDownWhileIdle(primingButton);
+  else
+    lockTimers.sleepUntilNextTask(millis());
 }  // end loop
 
-// check if elapsed time from start time to now exceeds a timeout in milliseconds
-bool isTimedOut(unsigned long startTime, unsigned long timeOut) {
-  if (millis() - startTime >= timeOut)
-    return true;
-  else
-    return false;
+// the debounce times are held by the buttons, the other settings are read where they are used
+void applySettings(void) {
+  primingButton.setDebounceTime(config.settings().primingDebounceTime);
+  comboButtons.setDebounceTime(config.settings().comboDebounceTime);
 }
 
-// not the most elegant solution comparing each element, but suitable for short combos
-bool compareArrays(const int arrayA[], const int arrayB[], const int length) {
-  bool same = true;
-  long i = 0;
-  while (i < length && same) {
-    same = arrayA[i] == arrayB[i];
-    i++;
-  }
-  return same;
-}
\ No newline at end of file
+#ifdef LOCK_LINK
+// the state, attempt counters and button counts, from firstButton on for as many as fit
+void writeTelemetry(frameWriter &out, uint8_t firstButton) {
+  out.put(lock.state());
+  out.put(attemptLog.failures());
+  out.put16(attemptLog.attempts());
+  out.put16(attemptLog.successes());
+  out.put32(primingButton.getCount());
+  out.put(comboButtonsCount);
+  if (firstButton > comboButtonsCount)
+    firstButton = comboButtonsCount;
+  uint8_t shown = out.room() >= 2 ? (out.room() - 2) / 4 : 0;
+  if (shown > comboButtonsCount - firstButton)
+    shown = comboButtonsCount - firstButton;
+  out.put(firstButton);
+  out.put(shown);
+  for (uint8_t i = firstButton; i < firstButton + shown; i++)
+    out.put32(comboButtons.getCount(i));
+}
+#endif
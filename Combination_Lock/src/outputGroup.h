@@ -0,0 +1,130 @@
+/*
+  outputGroup.h
+
+  The output side of buttonGroup. An outputGroup drives a fixed set of digital output pins from a
+  bitmask and caches the level of every pin, so only pins whose level actually changes are written.
+  On AVR boards the pins are sorted by port when the group is created, and a write updates each
+  affected port register with a single read-modify-write, done with interrupts disabled so it can't
+  clobber a port written from an interrupt. Pins on the same port therefore change at the same
+  instant. Elsewhere the group falls back to one digitalWrite() per changed pin.
+
+  const uint8_t pins[] = {4, 5, 6, 7};
+  outputGroup<4> outputs(pins);
+  outputs.write(0b1001);     // pins 4 and 7 HIGH, 5 and 6 LOW
+  outputs.toggle(2);         // pin 6 from the cached level, without reading the pin
+
+  Because writes go straight to the port, a pin whose timer is running PWM through analogWrite()
+  keeps doing so; the group is meant for plain on/off outputs.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef outputGroup_h
+#define outputGroup_h
+
+#include <buttonGroup.h>  // buttonMask
+
+template <uint8_t N>
+class outputGroup {
+ public:
+  typedef typename buttonMask<N>::type mask_t;
+
+  // sets every pin to an output driven LOW
+  outputGroup(const uint8_t pins[]) {
+    levels = 0;
+#ifdef __AVR__
+    portsUsed = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      pinMode(pins[i], OUTPUT);
+      digitalWrite(pins[i], LOW);
+      uint8_t port = digitalPinToPort(pins[i]);
+      if (port == NOT_A_PIN) {
+        bitMask[i] = 0;
+        portIndex[i] = 0;
+        continue;
+      }
+      bitMask[i] = digitalPinToBitMask(pins[i]);
+
+      volatile uint8_t *reg = portOutputRegister(port);
+      uint8_t p = 0;
+      while (p < portsUsed && outputRegister[p] != reg)
+        p++;
+      if (p == portsUsed)
+        outputRegister[portsUsed++] = reg;
+      portIndex[i] = p;
+    }
+#else
+    for (uint8_t i = 0; i < N; i++) {
+      pin[i] = pins[i];
+      pinMode(pin[i], OUTPUT);
+      digitalWrite(pin[i], LOW);
+    }
+#endif
+  }
+
+  // set the pins selected by which to the matching bits of newLevels, other pins keep their level
+  void write(mask_t newLevels, mask_t which = (mask_t)~(mask_t)0) {
+    mask_t changed = (newLevels ^ levels) & which;
+    if (!changed)
+      return;
+    levels ^= changed;
+
+#ifdef __AVR__
+    uint8_t setBits[portSlots] = {};
+    uint8_t clearBits[portSlots] = {};
+    mask_t bit = 1;
+    for (uint8_t i = 0; changed; i++, bit <<= 1) {
+      if (changed & bit) {
+        if (levels & bit)
+          setBits[portIndex[i]] |= bitMask[i];
+        else
+          clearBits[portIndex[i]] |= bitMask[i];
+        changed &= ~bit;
+      }
+    }
+
+    uint8_t oldSREG = SREG;
+    cli();
+    for (uint8_t p = 0; p < portsUsed; p++) {
+      if (setBits[p] | clearBits[p])
+        *outputRegister[p] = (*outputRegister[p] & ~clearBits[p]) | setBits[p];
+    }
+    SREG = oldSREG;
+#else
+    mask_t bit = 1;
+    for (uint8_t i = 0; changed; i++, bit <<= 1) {
+      if (changed & bit) {
+        digitalWrite(pin[i], (levels & bit) ? HIGH : LOW);
+        changed &= ~bit;
+      }
+    }
+#endif
+  }
+
+  void set(uint8_t index, bool level) { write(level ? bitOf(index) : 0, bitOf(index)); }
+  void toggle(uint8_t index) { write(levels ^ bitOf(index), bitOf(index)); }
+  bool get(uint8_t index) const { return levels & bitOf(index); }
+  mask_t state(void) const { return levels; }
+
+ private:
+  mask_t levels;  // cached level of every pin, bit i belongs to pin i
+
+  static mask_t bitOf(uint8_t index) { return (mask_t)1 << index; }
+
+#ifdef __AVR__
+  static const uint8_t portSlots = N < 11 ? N : 11;
+  volatile uint8_t *outputRegister[portSlots];
+  uint8_t portsUsed;
+  uint8_t portIndex[N];
+  uint8_t bitMask[N];
+#else
+  uint8_t pin[N];
+#endif
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+  packedSymbols.h
+
+  A fixed-capacity sequence of small symbols, such as button or key indices, packed as tightly as
+  the symbol count allows: 2 bits per symbol for up to 4 symbols, 4 bits for up to 16 and a whole
+  byte beyond that. A 64-press history of a 3-button keypad takes 18 bytes instead of the 128 an
+  int array needs on AVR.
+
+  packedSymbols<3, 64> history;  // symbols 0 to 2, room for 64 of them
+  history.push(2);                // appends, dropping the oldest symbol once full
+  history.get(0);                 // the oldest symbol kept
+
+  The sequence is a ring, so push() never moves stored symbols. Symbols are masked to the bits
+  available, so a symbol out of range wraps instead of spilling into its neighbours.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef packedSymbols_h
+#define packedSymbols_h
+
+#include <Arduino.h>
+
+template <uint16_t Symbols, uint8_t Capacity>
+class packedSymbols {
+  static_assert(Symbols > 1 && Symbols <= 256, "symbol count must be between 2 and 256");
+  static_assert(Capacity > 0, "capacity must be at least one symbol");
+
+ public:
+  static const uint8_t symbolBits = Symbols <= 4 ? 2 : Symbols <= 16 ? 4 : 8;
+
+  packedSymbols() { clear(); }
+
+  void clear(void) {
+    first = 0;
+    length = 0;
+    memset(bytes, 0, sizeof(bytes));
+  }
+
+  uint8_t size(void) const { return length; }
+  uint8_t capacity(void) const { return Capacity; }
+  bool full(void) const { return length == Capacity; }
+
+  // the symbol at a position counted from the oldest one kept
+  uint8_t get(uint8_t index) const { return read(slot(index)); }
+  void set(uint8_t index, uint8_t symbol) { write(slot(index), symbol); }
+
+  // the most recent symbol, or position back from it
+  uint8_t last(uint8_t back = 0) const { return get(length - 1 - back); }
+
+  void push(uint8_t symbol) {
+    if (length < Capacity) {
+      write(slot(length++), symbol);
+    } else {
+      write(first, symbol);
+      first = first + 1 == Capacity ? 0 : first + 1;
+    }
+  }
+
+  // compare against a plain array of symbols, oldest first; every symbol is compared even after a
+  // difference, so the time taken doesn't tell how many leading symbols matched
+  bool equals(const uint8_t symbols[], uint8_t count) const {
+    if (count != length)
+      return false;
+    uint8_t difference = 0;
+    for (uint8_t i = 0; i < count; i++)
+      difference |= get(i) ^ (symbols[i] & symbolMask);
+    return difference == 0;
+  }
+
+ private:
+  static const uint8_t symbolsPerByte = 8 / symbolBits;
+  static const uint8_t symbolMask = (uint8_t)((1 << symbolBits) - 1);
+
+  uint8_t bytes[(Capacity + symbolsPerByte - 1) / symbolsPerByte];
+  uint8_t first;  // slot of the oldest symbol
+  uint8_t length;
+
+  uint8_t slot(uint8_t index) const {
+    uint16_t s = (uint16_t)first + index;
+    return s >= Capacity ? s - Capacity : s;
+  }
+
+  uint8_t read(uint8_t s) const {
+    uint8_t shift = (s % symbolsPerByte) * symbolBits;
+    return (bytes[s / symbolsPerByte] >> shift) & symbolMask;
+  }
+
+  void write(uint8_t s, uint8_t symbol) {
+    uint8_t shift = (s % symbolsPerByte) * symbolBits;
+    uint8_t &b = bytes[s / symbolsPerByte];
+    b = (b & ~(symbolMask << shift)) | ((symbol & symbolMask) << shift);
+  }
+};
+
+#endif
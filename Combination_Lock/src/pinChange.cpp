@@ -0,0 +1,154 @@
+#include <pinChange.h>
+
+#if defined(__AVR__) && defined(PCICR)
+
+struct pinChangeSlot {
+  volatile uint8_t *inputRegister;  // NULL while the slot is free
+  uint8_t bitMask;
+  uint8_t group;      // PCICR bit of the pin
+  uint8_t lastLevel;  // last level seen by the interrupt
+  int pin;
+  pinEdgeBuffer buffer;
+};
+
+static pinChangeSlot slots[pinChangeMaxPins];
+
+// check every pin of a group against the level it had at the last interrupt
+static inline void capturePinChanges(uint8_t group) {
+  buttonTime_t now = buttonNow();
+  for (uint8_t i = 0; i < pinChangeMaxPins; i++) {
+    pinChangeSlot &slot = slots[i];
+    if (slot.inputRegister == NULL || slot.group != group)
+      continue;
+    uint8_t level = (*slot.inputRegister & slot.bitMask) ? HIGH : LOW;
+    if (level != slot.lastLevel) {
+      slot.lastLevel = level;
+      slot.buffer.push(now, level);
+    }
+  }
+}
+
+ISR(PCINT0_vect) { capturePinChanges(0); }
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect) { capturePinChanges(1); }
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect) { capturePinChanges(2); }
+#endif
+#if defined(PCINT3_vect)
+ISR(PCINT3_vect) { capturePinChanges(3); }
+#endif
+
+pinEdgeBuffer *attachPinChange(int pin) {
+  volatile uint8_t *pcicr = digitalPinToPCICR(pin);
+  volatile uint8_t *pcmsk = digitalPinToPCMSK(pin);
+  uint8_t port = digitalPinToPort(pin);
+  if (pcicr == NULL || pcmsk == NULL || port == NOT_A_PIN)
+    return NULL;
+
+  // a pin attached again keeps its slot, so its edges are never queued twice
+  uint8_t i = 0;
+  while (i < pinChangeMaxPins && (slots[i].inputRegister == NULL || slots[i].pin != pin))
+    i++;
+  if (i == pinChangeMaxPins) {
+    i = 0;
+    while (i < pinChangeMaxPins && slots[i].inputRegister != NULL)
+      i++;
+    if (i == pinChangeMaxPins)
+      return NULL;
+  }
+
+  pinChangeSlot &slot = slots[i];
+  uint8_t oldSREG = SREG;
+  cli();
+  slot.pin = pin;
+  slot.bitMask = digitalPinToBitMask(pin);
+  slot.group = digitalPinToPCICRbit(pin);
+  slot.inputRegister = portInputRegister(port);
+  slot.lastLevel = (*slot.inputRegister & slot.bitMask) ? HIGH : LOW;
+  slot.buffer.clear();
+  // a flag raised while the group was off is stale and would fire as soon as it is enabled
+  if (!(*pcicr & _BV(slot.group)))
+    PCIFR = _BV(slot.group);
+  *pcmsk |= _BV(digitalPinToPCMSKbit(pin));
+  *pcicr |= _BV(slot.group);
+  SREG = oldSREG;
+
+  return &slot.buffer;
+}
+
+void detachPinChange(int pin) {
+  for (uint8_t i = 0; i < pinChangeMaxPins; i++) {
+    if (slots[i].inputRegister != NULL && slots[i].pin == pin) {
+      uint8_t oldSREG = SREG;
+      cli();
+      *digitalPinToPCMSK(pin) &= ~_BV(digitalPinToPCMSKbit(pin));
+      slots[i].inputRegister = NULL;
+      SREG = oldSREG;
+    }
+  }
+}
+
+#elif defined(ARDUINO_NATIVE)
+
+// the native core calls a handler whenever a driven pin changes level, standing in for the interrupt
+struct pinChangeSlot {
+  bool used;
+  int pin;
+  pinEdgeBuffer buffer;
+};
+
+static pinChangeSlot slots[pinChangeMaxPins];
+
+static void capturePinChange(uint8_t pin, uint8_t level) {
+  for (uint8_t i = 0; i < pinChangeMaxPins; i++) {
+    if (slots[i].used && slots[i].pin == pin)
+      slots[i].buffer.push(buttonNow(), level);
+  }
+}
+
+pinEdgeBuffer *attachPinChange(int pin) {
+  if (pin < 0 || pin >= NUM_DIGITAL_PINS)
+    return NULL;
+
+  // a pin attached again keeps its slot, so its edges are never queued twice
+  uint8_t i = 0;
+  while (i < pinChangeMaxPins && !(slots[i].used && slots[i].pin == pin))
+    i++;
+  if (i == pinChangeMaxPins) {
+    i = 0;
+    while (i < pinChangeMaxPins && slots[i].used)
+      i++;
+    if (i == pinChangeMaxPins)
+      return NULL;
+  }
+
+  slots[i].used = true;
+  slots[i].pin = pin;
+  slots[i].buffer.clear();
+  nativeHal::onPinChange(pin, capturePinChange);
+  return &slots[i].buffer;
+}
+
+void detachPinChange(int pin) {
+  for (uint8_t i = 0; i < pinChangeMaxPins; i++) {
+    if (slots[i].used && slots[i].pin == pin) {
+      slots[i].used = false;
+      nativeHal::onPinChange(pin, NULL);
+    }
+  }
+}
+
+#else
+
+// boards without pin change interrupts keep polling
+pinEdgeBuffer *attachPinChange(int pin) {
+  (void)pin;
+  return NULL;
+}
+
+void detachPinChange(int pin) {
+  (void)pin;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+  pinChange.h
+
+  Pin change interrupt capture for buttons that can't rely on being polled. Once a pin is attached,
+  every change of its level is timestamped inside the pin change interrupt, in the buttons'
+  timebase (buttonTime.h), and queued in a small ring buffer owned by that pin. The ring buffer is
+  lock-free with a single producer (the interrupt) and a single consumer (the sketch), so draining
+  it never disables interrupts. Edges that happen while loop() is blocked, for example by a
+  delay(), wait in the buffer until they are drained.
+
+  The button library uses this through button::enableInterrupts(). Each pin change interrupt group
+  is shared by up to eight pins, and all pins of a group are checked whenever any of them changes.
+  AVR boards with pin change interrupts and the native build are supported; elsewhere
+  attachPinChange() returns NULL and buttons fall back to polling.
+
+  Note: this module defines the PCINT interrupt vectors, so it cannot be combined with other
+  libraries that define them too, such as SoftwareSerial.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef pinChange_h
+#define pinChange_h
+
+#include <Arduino.h>
+#include <buttonTime.h>
+
+// maximum number of pins that can be attached at the same time
+const uint8_t pinChangeMaxPins = 8;
+
+// keeps the compiler from moving buffer accesses across index updates
+#define pinChangeBarrier() __asm__ __volatile__("" ::: "memory")
+
+struct pinEdge {
+  buttonTime_t time;  // buttonNow() when the interrupt saw the change
+  uint8_t level;      // the level the pin changed to, HIGH or LOW
+};
+
+class pinEdgeBuffer {
+ public:
+  static const uint8_t capacity = 8;  // must be a power of two
+
+  pinEdgeBuffer() : head(0), tail(0), overflow(false) {}
+
+  // producer side, only called from the interrupt
+  void push(buttonTime_t time, uint8_t level) {
+    uint8_t next = (head + 1) & (capacity - 1);
+    if (next == tail) {  // full, the consumer resynchronizes from the pin itself
+      overflow = true;
+      return;
+    }
+    edges[head].time = time;
+    edges[head].level = level;
+    pinChangeBarrier();
+    head = next;
+  }
+
+  // consumer side, only called from the sketch
+  bool pop(pinEdge &edge) {
+    if (tail == head)
+      return false;
+    pinChangeBarrier();
+    edge = edges[tail];
+    pinChangeBarrier();
+    tail = (tail + 1) & (capacity - 1);
+    return true;
+  }
+
+  // true once after edges were dropped because the buffer was full
+  bool overflowed(void) {
+    if (!overflow)
+      return false;
+    overflow = false;
+    return true;
+  }
+
+  bool empty(void) const { return tail == head; }
+
+  void clear(void) { tail = head; }
+
+ private:
+  pinEdge edges[capacity];
+  volatile uint8_t head;  // written by the producer only
+  volatile uint8_t tail;  // written by the consumer only
+  volatile bool overflow;
+};
+
+// start capturing edges on a pin, returns NULL when the pin or board isn't supported or all slots
+// are taken
+pinEdgeBuffer *attachPinChange(int pin);
+
+// stop capturing edges on a pin and free its slot
+void detachPinChange(int pin);
+
+#endif
@@ -0,0 +1,32 @@
+#include <powerDown.h>
+
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
+
+void powerDownWhileIdle(button &wakeButton) {
+#if defined(__AVR__)
+  uint8_t adcState = ADCSRA;
+  ADCSRA &= ~_BV(ADEN);
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+
+  cli();
+  if (wakeButton.isIdle()) {
+    sleep_enable();
+#if defined(BODS) && defined(BODSE)
+    sleep_bod_disable();
+#endif
+    sei();  // the instruction after sei() always runs, so no interrupt can slip in before sleeping
+    sleep_cpu();
+    sleep_disable();
+  }
+  sei();
+
+  ADCSRA = adcState;
+#elif defined(ARDUINO_NATIVE)
+  if (wakeButton.isIdle())
+    nativeHal::advance(1000);
+#else
+  (void)wakeButton;
+#endif
+}
@@ -0,0 +1,33 @@
+/*
+  powerDown.h
+
+  Deep sleep for sketches that spend most of their time waiting on a single button. While a button
+  in interrupt mode is idle (see button::isIdle()), powerDownWhileIdle() puts the AVR into its
+  power-down sleep mode, the lowest power mode that a pin change can still wake it from. The ADC
+  and, where supported, the brown-out detector are switched off for the duration of the sleep.
+
+  Timer 0 stops in power-down, so millis() does not advance while asleep. Call this only when no
+  millis() based timeout or scheduled task is pending; between wake-ups elapsed times are measured
+  as if no time had passed during sleep. The check for an idle button is repeated with interrupts
+  disabled right before sleeping, so an edge that arrives just before can't be slept through.
+
+  On the native build there is no sleep; the virtual clock moves on by a millisecond instead, like
+  an idle pass.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef powerDown_h
+#define powerDown_h
+
+#include <button.h>
+
+// sleep until the wake button's pin changes, returns right away if the button isn't idle
+void powerDownWhileIdle(button &wakeButton);
+
+#endif
@@ -0,0 +1,157 @@
+#include <profiler.h>
+
+#ifdef LOCK_PROFILE
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#else
+#include <stdlib.h>
+#include <time.h>
+#endif
+
+static profileStats sections[PROFILE_SECTIONS];
+static uint32_t overhead;  // cost of an empty section, taken off every sample
+
+#if defined(__AVR__)
+static volatile uint16_t timerOverflows;
+
+ISR(TIMER1_OVF_vect) {
+  timerOverflows++;
+}
+
+uint32_t profiler::now(void) {
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t low = TCNT1;
+  uint16_t high = timerOverflows;
+  // an overflow that hasn't been serviced yet belongs to a count that has already wrapped
+  if ((TIFR1 & _BV(TOV1)) && low < 0x8000)
+    high++;
+  SREG = oldSREG;
+  return ((uint32_t)high << 16) | low;
+}
+
+static void startClock(void) {
+  uint8_t oldSREG = SREG;
+  cli();
+  TCCR1A = 0;  // normal mode, no PWM
+  TCCR1B = _BV(CS10);  // count every CPU cycle
+  TCNT1 = 0;
+  timerOverflows = 0;
+  TIFR1 = _BV(TOV1);
+  TIMSK1 = _BV(TOIE1);
+  SREG = oldSREG;
+}
+
+static const char unit[] = "cycles";
+#else
+uint32_t profiler::now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint32_t)((uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec);
+}
+
+static const char unit[] = "ns";
+
+static const char *const *exitNames;
+static uint8_t exitCount;
+
+static void dumpAtExit(void) {
+  if (exitNames != NULL)
+    profiler::dump(exitNames, exitCount);
+}
+
+static void startClock(void) {
+  atexit(dumpAtExit);
+}
+#endif
+
+void profiler::begin(void) {
+  Serial.begin(PROFILE_BAUD);
+  startClock();
+  overhead = 0;
+  uint32_t fastest = 0xFFFFFFFFUL;
+  for (uint8_t i = 0; i < 16; i++) {
+    uint32_t start = now();
+    uint32_t elapsed = now() - start;
+    if (elapsed < fastest)
+      fastest = elapsed;
+  }
+  overhead = fastest;
+  reset();
+}
+
+void profiler::record(uint8_t section, uint32_t elapsed) {
+  if (section >= PROFILE_SECTIONS)
+    return;
+  profileStats &s = sections[section];
+  elapsed = elapsed > overhead ? elapsed - overhead : 0;
+
+  if (s.count == 0 || elapsed < s.min)
+    s.min = elapsed;
+  if (elapsed > s.max)
+    s.max = elapsed;
+  s.count++;
+  s.total += elapsed;
+
+  uint8_t bucket = 0;
+  for (uint32_t bound = 32; bucket < profileBuckets - 1 && elapsed >= bound; bound <<= 1)
+    bucket++;
+  if (s.histogram[bucket] < 0xFFFF)
+    s.histogram[bucket]++;
+}
+
+const profileStats &profiler::stats(uint8_t section) {
+  return sections[section < PROFILE_SECTIONS ? section : 0];
+}
+
+void profiler::reset(void) {
+  memset(sections, 0, sizeof(sections));
+}
+
+void profiler::dump(const char *const names[], uint8_t count) {
+  Serial.print("profile (");
+  Serial.print(unit);
+  Serial.print(", overhead ");
+  Serial.print(overhead);
+  Serial.println(" removed)");
+  Serial.print("section: count min mean max | <32 <64 <128 <256 <512 <1k <2k <4k <8k >=8k");
+  Serial.println();
+
+  for (uint8_t i = 0; i < count && i < PROFILE_SECTIONS; i++) {
+    const profileStats &s = sections[i];
+    if (s.count == 0)
+      continue;
+    Serial.print(names[i]);
+    Serial.print(": ");
+    Serial.print(s.count);
+    Serial.print(' ');
+    Serial.print(s.min);
+    Serial.print(' ');
+    Serial.print((unsigned long)(s.total / s.count));
+    Serial.print(' ');
+    Serial.print(s.max);
+    Serial.print(" |");
+    for (uint8_t b = 0; b < profileBuckets; b++) {
+      Serial.print(' ');
+      Serial.print(s.histogram[b]);
+    }
+    Serial.println();
+  }
+}
+
+void profiler::poll(const char *const names[], uint8_t count) {
+#ifndef __AVR__
+  exitNames = names;
+  exitCount = count;
+#endif
+  if (Serial.available() == 0)
+    return;
+  int request = Serial.read();
+  if (request == 'p')
+    dump(names, count);
+  else if (request == 'r')
+    reset();
+}
+
+#endif
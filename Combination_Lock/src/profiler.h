@@ -0,0 +1,117 @@
+/*
+  profiler.h
+
+  Opt-in timing of hot code paths. Build with -D LOCK_PROFILE (the uno_profile and native_profile
+  environments do) and every PROFILE_SCOPE() records how long the rest of its enclosing block took.
+  Without the flag the macros expand to nothing and no code, RAM or timer is used.
+
+  enum { SCAN, SECTION_COUNT };
+  const char *const sectionNames[SECTION_COUNT] = {"scan"};
+
+  void setup() {
+    PROFILE_BEGIN();
+  }
+
+  void loop() {
+    {
+      PROFILE_SCOPE(SCAN);
+      ...
+    }
+    PROFILE_DUMP_ON_REQUEST(sectionNames);
+  }
+
+  Each section keeps its count, minimum, maximum and total, and a histogram with a bucket per power
+  of two, in a fixed table of PROFILE_SECTIONS entries (8 unless defined otherwise). The cost of
+  reading the clock twice is measured once by PROFILE_BEGIN() and taken off every sample. Sections
+  may nest; an outer section includes the time of the sections inside it.
+
+  On AVR boards the clock is timer 1, reconfigured to count CPU cycles with no prescaler and
+  extended to 32 bits by its overflow interrupt, so samples are in cycles and stay exact up to
+  about four minutes at 16 MHz. PWM through analogWrite() on the timer 1 pins (9 and 10 on an Uno)
+  stops working while profiling. On the native build the virtual clock doesn't move within a pass of
+  loop(), so the host's monotonic clock is used instead and samples are in nanoseconds.
+
+  PROFILE_BEGIN() opens Serial at PROFILE_BAUD (115200 unless defined otherwise). The statistics
+  are printed over it when a 'p' is received and cleared when an 'r' is received. A board in
+  power-down sleep won't see the request until it wakes. The native build also prints them when
+  the run ends.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef profiler_h
+#define profiler_h
+
+#include <Arduino.h>
+
+#ifdef LOCK_PROFILE
+
+#ifndef PROFILE_SECTIONS
+#define PROFILE_SECTIONS 8
+#endif
+
+#ifndef PROFILE_BAUD
+#define PROFILE_BAUD 115200
+#endif
+
+// bucket i counts samples below 32 << i, the last bucket everything longer
+const uint8_t profileBuckets = 10;
+
+struct profileStats {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+  uint16_t histogram[profileBuckets];  // saturates at 65535
+};
+
+namespace profiler {
+
+// start the clock and measure its own overhead
+void begin(void);
+
+// free-running clock in cycles on AVR, nanoseconds on the host
+uint32_t now(void);
+
+void record(uint8_t section, uint32_t elapsed);
+const profileStats &stats(uint8_t section);
+void reset(void);
+
+// print every section that has samples, names[i] labels section i
+void dump(const char *const names[], uint8_t count);
+
+// handle a pending 'p' (dump) or 'r' (reset) request on Serial
+void poll(const char *const names[], uint8_t count);
+
+}  // namespace profiler
+
+class profileScope {
+ public:
+  explicit profileScope(uint8_t section) : section(section), start(profiler::now()) {}
+  ~profileScope() { profiler::record(section, profiler::now() - start); }
+
+ private:
+  uint8_t section;
+  uint32_t start;
+};
+
+#define PROFILE_JOIN_(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_(a, b)
+#define PROFILE_SCOPE(section) profileScope PROFILE_JOIN(profileScope, __LINE__)(section)
+#define PROFILE_BEGIN() profiler::begin()
+#define PROFILE_DUMP_ON_REQUEST(names) profiler::poll(names, sizeof(names) / sizeof(names[0]))
+
+#else
+
+#define PROFILE_SCOPE(section)
+#define PROFILE_BEGIN()
+#define PROFILE_DUMP_ON_REQUEST(names)
+
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+#include <ramReport.h>
+
+#ifdef LOCK_RAM_REPORT
+
+#ifdef __AVR__
+extern char __data_start;
+extern char __bss_end;
+extern char __heap_start;
+extern char *__brkval;
+#endif
+
+static size_t reported;
+
+void ramReportBegin(void) {
+  Serial.begin(RAM_REPORT_BAUD);
+  Serial.println(F("RAM (bytes)"));
+  reported = 0;
+}
+
+void ramReportLine(const __FlashStringHelper *name, size_t bytes) {
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.println((unsigned long)bytes);
+  reported += bytes;
+}
+
+void ramReportEnd(void) {
+  Serial.print(F("total reported: "));
+  Serial.println((unsigned long)reported);
+#ifdef __AVR__
+  char stackTop;
+  char *heapEnd = __brkval != NULL ? __brkval : &__heap_start;
+  Serial.print(F("static data: "));
+  Serial.println((unsigned long)(&__bss_end - &__data_start));
+  Serial.print(F("free: "));
+  Serial.println((unsigned long)(&stackTop - heapEnd));
+#endif
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*
+  ramReport.h
+
+  Opt-in report of how much SRAM a sketch's objects take. Build with -D LOCK_RAM_REPORT (the
+  uno_ram_report environment does) and the RAM_REPORT() lines print the size of each object over
+  Serial, followed by their total. On AVR boards the report ends with the size of all static data
+  and the RAM left between the heap and the stack at that point. Without the flag the macros expand
+  to nothing.
+
+  void setup() {
+    RAM_REPORT_BEGIN();
+    RAM_REPORT(buttons);
+    RAM_REPORT(tasks);
+    RAM_REPORT_END();
+  }
+
+  Sizes are those of the build being run, so the native build reports host sizes, where pointers
+  and unsigned long are 8 bytes; only the AVR report reflects the board.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef ramReport_h
+#define ramReport_h
+
+#include <Arduino.h>
+
+#ifdef LOCK_RAM_REPORT
+
+#ifndef RAM_REPORT_BAUD
+#define RAM_REPORT_BAUD 115200
+#endif
+
+void ramReportBegin(void);
+void ramReportLine(const __FlashStringHelper *name, size_t bytes);
+void ramReportEnd(void);
+
+#define RAM_REPORT_BEGIN() ramReportBegin()
+#define RAM_REPORT(object) ramReportLine(F(#object), sizeof(object))
+#define RAM_REPORT_END() ramReportEnd()
+
+#else
+
+#define RAM_REPORT_BEGIN()
+#define RAM_REPORT(object)
+#define RAM_REPORT_END()
+
+#endif
+
+#endif
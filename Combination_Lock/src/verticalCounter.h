@@ -0,0 +1,111 @@
+/*
+  verticalCounter.h
+
+  A bit-parallel debounce engine built from vertical counters. Each input owns one bit in each of
+  two counter words, so a 2-bit counter for every input in a group is updated at once with a
+  handful of AND/XOR operations regardless of how many inputs there are. An input's counter runs
+  while its sample disagrees with its debounced state and resets as soon as they agree again; when
+  the counter rolls over after four consecutive disagreeing samples the debounced state flips.
+
+  verticalCounter is the raw engine and works with any unsigned integer width, so up to 8, 16, or
+  32 inputs can be debounced per update. verticalButtonGroup wraps it with the port sampling and
+  queries of buttonGroup, so it has the same isPressed(), isReleased() and getCount() interface,
+  though not the same debouncing (see below):
+
+  const uint8_t pins[] = {9, 10, 11};
+  verticalButtonGroup<3> buttons(pins, INPUT, false);
+  buttons.setDebounceTime(50);
+
+  The debounce time is spread over the four samples, so the group samples its pins every quarter
+  of the debounce time, rounded up to a whole millisecond, and ignores scans in between. The
+  smallest usable debounce time is therefore 4 ms, and shorter times are raised to it. A press is
+  reported between three and four sample intervals after the contacts settle. Debouncing needs two
+  bits of RAM per button instead of the flickerable state and 4-byte timer the per-button engines
+  keep.
+
+  What it gives up for that is accuracy. It only looks at the pins once per sample interval, so a
+  bounce that happens to read the same level on four samples in a row counts as an edge, and one
+  that falls between samples isn't seen at all. In bench_debounce's generated trace it reports 2
+  phantom presses at the 4 ms floor, where button, button with interrupts and buttonGroup are
+  clean from 2 ms up, and it has no debounce time free of both phantom and missed presses. Use it
+  where RAM or scan time matter more than every press, and a per-button engine or buttonGroup
+  where they don't.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef verticalCounter_h
+#define verticalCounter_h
+
+#include <buttonGroup.h>
+
+// number of consecutive disagreeing samples before an input changes state
+const uint8_t verticalCounterSamples = 4;
+
+template <typename mask_t>
+class verticalCounter {
+ public:
+  verticalCounter() : cnt0(0), cnt1(0) {}
+
+  // feed one sample and return the bits of state that should toggle
+  mask_t update(mask_t sample, mask_t state) {
+    mask_t delta = sample ^ state;  // inputs that disagree with their debounced state
+    cnt1 = (cnt1 ^ cnt0) & delta;   // count up where they disagree, clear where they agree
+    cnt0 = ~cnt0 & delta;
+    return delta & ~(cnt0 | cnt1);  // a counter that rolled over to zero has seen enough samples
+  }
+
+  void reset(void) {
+    cnt0 = 0;
+    cnt1 = 0;
+  }
+
+ private:
+  mask_t cnt0;  // low bit of every input's counter
+  mask_t cnt1;  // high bit of every input's counter
+};
+
+template <uint8_t N, typename count_t = unsigned long>
+class verticalButtonGroup : public buttonGroupCore<N, count_t> {
+  typedef buttonGroupCore<N, count_t> core;
+
+ public:
+  typedef typename core::mask_t mask_t;
+
+  verticalButtonGroup(const uint8_t pins[], uint8_t mode, bool pullUpResistor)
+      : core(pins, mode, pullUpResistor) {
+    sampleInterval = 0;
+    lastSampleTime = 0;
+  }
+
+  // rounded up to whole milliseconds per sample, so anything up to four debounces for 4 ms
+  void setDebounceTime(unsigned long time) {
+    sampleInterval = (time + verticalCounterSamples - 1) / verticalCounterSamples;
+    if (sampleInterval < 1)
+      sampleInterval = 1;
+  }
+
+  void loop(void) { loop(millis()); }
+
+  // scans between sample intervals only clear the previous scan's edges
+  void loop(unsigned long currentTime) {
+    if (currentTime - lastSampleTime < sampleInterval) {
+      this->commitEdges(0);
+      return;
+    }
+    lastSampleTime = currentTime;
+    this->commitEdges(counter.update(this->sample(), this->steady));
+  }
+
+ private:
+  verticalCounter<mask_t> counter;
+  unsigned long sampleInterval;
+  unsigned long lastSampleTime;
+};
+
+#endif
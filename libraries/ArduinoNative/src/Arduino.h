@@ -0,0 +1,211 @@
+/*
+  Arduino.h (native)
+
+  A host-side stand-in for the parts of the Arduino core used by the sketches in this sketchbook, so
+  they can be built and run on Linux with PlatformIO's native platform ([env:native]). Sketches and
+  libraries compile unchanged; only the hardware behind the core functions is simulated.
+
+  Time is virtual. millis() and micros() read a microsecond clock that only moves when the runner
+  advances it after each pass of loop(), or when the sketch calls delay(). Nothing depends on how
+  fast the host is, so runs are repeatable. Unlike an AVR, the clock is 64 bits wide and millis()
+  and micros() never wrap; code that needs wrap-around behaviour should start the clock near the
+  wrap point with nativeHal::reset().
+
+  Input pins read whatever level has been driven onto them from outside. A pin nobody drives reads
+  HIGH in INPUT_PULLUP mode and LOW otherwise, like a button wired with a pull-up or pull-down
+  resistor. Outputs read back the level last written to them. Pin levels can be driven immediately
+  or scheduled at a future time, either from code through the nativeHal functions below or from a
+  script file of "<time in ms> <pin> <level>" lines, where the time may have a fractional part for
+  microsecond resolution and # starts a comment.
+
+  Switches between two pins, such as the keys of a matrix keypad, can be closed and opened the same
+  way, or with "<time in ms> <pin>-<pin> <1 to close, 0 to open>" script lines. Pins joined through
+  closed switches share one level: LOW if any of them is an output driving LOW, else HIGH if one
+  drives HIGH. Otherwise each reads the level driven onto it from outside if any, else HIGH if any
+  of the joined pins has its pull-up on.
+  Closing and opening switches doesn't raise pin change interrupts.
+
+  The default runner calls setup() and then loop() until the requested run time has passed,
+  advancing the clock by a fixed cost per pass. Programs that want to drive the simulation
+  themselves, such as benchmarks, define their own main() and the runner is left out. Options:
+
+  --run-ms <ms>        virtual time to run for (default 10000)
+  --loop-us <us>       virtual time each pass of loop() takes (default 10)
+  --script <file>      scheduled input levels to load before setup()
+  --eeprom <file>      EEPROM contents to load before setup() and save after the run (EEPROM.h)
+  --trace              print every change of an output pin
+
+  Serial is connected to the runner's standard input and output. Reads never block; available()
+  reports bytes that can be read without waiting.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/pgmspace.h>
+
+#define ARDUINO 10819
+#define ARDUINO_NATIVE
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define NOT_A_PIN 0
+#define NUM_DIGITAL_PINS 70  // enough for sketches written for a Mega
+#define LED_BUILTIN 13
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define _BV(bit) (1 << (bit))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// strings in flash are ordinary strings on the host
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+// the printing half of the Arduino Print class
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) { return str == NULL ? 0 : write((const uint8_t *)str, strlen(str)); }
+
+  size_t print(const __FlashStringHelper *str) { return write(reinterpret_cast<const char *>(str)); }
+  size_t print(const char str[]) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(long long n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned long long n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(double n, int digits = 2);
+
+  size_t println(void) { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) { return print(value) + println(); }
+  template <typename T>
+  size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+// Serial on the host, reading and writing file descriptors instead of a UART
+class HardwareSerial : public Print {
+ public:
+  HardwareSerial() : inputFd(0), outputFd(1), peeked(-1) {}
+  void begin(unsigned long baud) { (void)baud; }
+  void end(void) {}
+  int available(void);
+  int peek(void);
+  int read(void);
+  void flush(void) {}
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size);
+  using Print::write;
+  operator bool() { return true; }
+
+  // connect Serial to other file descriptors, e.g. a pseudo terminal
+  void attach(int inFd, int outFd);
+
+ private:
+  int inputFd;
+  int outputFd;
+  int peeked;  // a byte read ahead by available() or peek(), -1 if none
+};
+
+extern HardwareSerial Serial;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+inline void interrupts(void) {}
+inline void noInterrupts(void) {}
+
+void setup(void);
+void loop(void);
+
+namespace nativeHal {
+
+typedef void (*pinHandler)(uint8_t pin, uint8_t level);
+typedef void (*timerHandler)(void);
+
+// clear pins, schedules and handlers and restart the virtual clock
+void reset(uint64_t startMicros = 0);
+
+// virtual microseconds since reset
+uint64_t now(void);
+
+// move the clock forward, applying scheduled pin levels and firing timers on the way
+void advance(uint64_t micros);
+
+// drive an input pin from outside, now or at a future time
+void setPin(uint8_t pin, uint8_t level);
+void schedulePin(uint8_t pin, uint64_t atMicros, uint8_t level);
+bool loadScript(const char *path);
+
+// release a pin so it reads its idle level again
+void releasePin(uint8_t pin);
+
+// close or open a switch between two pins, now or at a future time
+void setSwitch(uint8_t pinA, uint8_t pinB, bool closed);
+void scheduleSwitch(uint8_t pinA, uint8_t pinB, uint64_t atMicros, bool closed);
+
+// the level last written to a pin with digitalWrite() and the mode set with pinMode()
+uint8_t outputLevel(uint8_t pin);
+uint8_t modeOf(uint8_t pin);
+
+// emulated interrupts: called when a driven pin changes level, or periodically
+void onPinChange(uint8_t pin, pinHandler handler);
+void attachTimer(uint32_t periodMicros, timerHandler handler);
+void detachTimer(timerHandler handler);
+
+// observe output changes, e.g. to record or check what a sketch drives
+void onPinWrite(pinHandler handler);
+void setTrace(bool enabled);
+
+// the default runner behind main()
+int run(int argc, char **argv);
+
+}  // namespace nativeHal
+
+#endif
@@ -0,0 +1,325 @@
+#include <Arduino.h>
+
+#include <stdio.h>
+
+#include <map>
+#include <vector>
+
+namespace {
+
+struct pinState {
+  uint8_t mode;
+  uint8_t output;  // last level written with digitalWrite()
+  uint8_t driven;  // level driven from outside
+  bool isDriven;
+  nativeHal::pinHandler changeHandler;
+};
+
+struct scheduledLevel {
+  uint8_t pin;
+  uint8_t level;
+  uint8_t otherPin;  // the far end when a switch is scheduled instead of a level
+  bool isSwitch;
+};
+
+struct periodicTimer {
+  uint32_t period;
+  uint64_t next;
+  nativeHal::timerHandler handler;
+};
+
+// the clock is constant initialized so sketches may call millis() from global constructors
+uint64_t clockMicros = 0;
+pinState pins[NUM_DIGITAL_PINS];
+nativeHal::pinHandler writeHandler = NULL;
+bool trace = false;
+
+// containers live behind functions so they exist before any global constructor touches a pin
+std::multimap<uint64_t, scheduledLevel> &schedule() {
+  static std::multimap<uint64_t, scheduledLevel> levels;
+  return levels;
+}
+
+std::vector<periodicTimer> &timers() {
+  static std::vector<periodicTimer> list;
+  return list;
+}
+
+// closed switches between pins, such as the keys of a matrix keypad
+std::vector<std::pair<uint8_t, uint8_t> > &switches() {
+  static std::vector<std::pair<uint8_t, uint8_t> > closed;
+  return closed;
+}
+
+uint8_t levelOf(uint8_t pin) {
+  const pinState &state = pins[pin];
+  if (state.mode == OUTPUT)
+    return state.output;
+
+  std::vector<std::pair<uint8_t, uint8_t> > &closed = switches();
+  if (!closed.empty()) {
+    // every pin joined to this one through closed switches shares its level: an output driving LOW
+    // wins over one driving HIGH, and any output wins over pull-ups
+    bool joined[NUM_DIGITAL_PINS] = {};
+    uint8_t stack[NUM_DIGITAL_PINS];
+    uint8_t depth = 0;
+    bool anyHigh = false, anyLow = false, pulledUp = false;
+    joined[pin] = true;
+    stack[depth++] = pin;
+    while (depth > 0) {
+      uint8_t p = stack[--depth];
+      if (pins[p].mode == OUTPUT)
+        (pins[p].output ? anyHigh : anyLow) = true;
+      else if (pins[p].mode == INPUT_PULLUP)
+        pulledUp = true;
+      for (size_t i = 0; i < closed.size(); i++) {
+        uint8_t other;
+        if (closed[i].first == p)
+          other = closed[i].second;
+        else if (closed[i].second == p)
+          other = closed[i].first;
+        else
+          continue;
+        if (!joined[other]) {
+          joined[other] = true;
+          stack[depth++] = other;
+        }
+      }
+    }
+    if (anyLow)
+      return LOW;
+    if (anyHigh)
+      return HIGH;
+    if (state.isDriven)
+      return state.driven;
+    return pulledUp ? HIGH : LOW;
+  }
+
+  if (state.isDriven)
+    return state.driven;
+  return state.mode == INPUT_PULLUP ? HIGH : LOW;
+}
+
+void closeSwitch(uint8_t pinA, uint8_t pinB, bool closed) {
+  if (pinA >= NUM_DIGITAL_PINS || pinB >= NUM_DIGITAL_PINS || pinA == pinB)
+    return;
+  std::vector<std::pair<uint8_t, uint8_t> > &list = switches();
+  for (size_t i = 0; i < list.size(); i++) {
+    if ((list[i].first == pinA && list[i].second == pinB) ||
+        (list[i].first == pinB && list[i].second == pinA)) {
+      if (!closed)
+        list.erase(list.begin() + i);
+      return;
+    }
+  }
+  if (closed)
+    list.push_back(std::make_pair(pinA, pinB));
+}
+
+void drive(uint8_t pin, bool isDriven, uint8_t level) {
+  if (pin >= NUM_DIGITAL_PINS)
+    return;
+  uint8_t before = levelOf(pin);
+  pins[pin].isDriven = isDriven;
+  pins[pin].driven = level ? HIGH : LOW;
+  uint8_t after = levelOf(pin);
+  if (after != before && pins[pin].changeHandler != NULL)
+    pins[pin].changeHandler(pin, after);
+}
+
+}  // namespace
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < NUM_DIGITAL_PINS)
+    pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= NUM_DIGITAL_PINS)
+    return;
+  uint8_t level = val ? HIGH : LOW;
+  if (pins[pin].output == level)
+    return;
+  pins[pin].output = level;
+  if (trace)
+    printf("%10.3f ms  pin %2u -> %s\n", clockMicros / 1000.0, pin, level ? "HIGH" : "LOW");
+  if (writeHandler != NULL)
+    writeHandler(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS)
+    return LOW;
+  return levelOf(pin);
+}
+
+void analogWrite(uint8_t pin, int val) {
+  // no PWM is simulated, the pin is HIGH for the upper half of the range like a threshold
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, val >= 128 ? HIGH : LOW);
+}
+
+unsigned long millis(void) {
+  return clockMicros / 1000;
+}
+
+unsigned long micros(void) {
+  return clockMicros;
+}
+
+void delay(unsigned long ms) {
+  nativeHal::advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  nativeHal::advance(us);
+}
+
+namespace nativeHal {
+
+void reset(uint64_t startMicros) {
+  clockMicros = startMicros;
+  memset(pins, 0, sizeof(pins));
+  schedule().clear();
+  timers().clear();
+  switches().clear();
+  writeHandler = NULL;
+}
+
+uint64_t now(void) {
+  return clockMicros;
+}
+
+void advance(uint64_t micros) {
+  uint64_t target = clockMicros + micros;
+  std::multimap<uint64_t, scheduledLevel> &levels = schedule();
+  std::vector<periodicTimer> &list = timers();
+
+  for (;;) {
+    // apply whichever comes first, a scheduled level or a timer, levels first on a tie
+    periodicTimer *timer = NULL;
+    for (size_t i = 0; i < list.size(); i++) {
+      if (list[i].next <= target && (timer == NULL || list[i].next < timer->next))
+        timer = &list[i];
+    }
+    bool levelDue = !levels.empty() && levels.begin()->first <= target;
+
+    if (levelDue && (timer == NULL || levels.begin()->first <= timer->next)) {
+      std::multimap<uint64_t, scheduledLevel>::iterator first = levels.begin();
+      if (first->first > clockMicros)
+        clockMicros = first->first;
+      scheduledLevel level = first->second;
+      levels.erase(first);
+      if (level.isSwitch)
+        closeSwitch(level.pin, level.otherPin, level.level);
+      else
+        drive(level.pin, true, level.level);
+    } else if (timer != NULL) {
+      clockMicros = timer->next;
+      timer->next += timer->period;
+      timerHandler handler = timer->handler;  // the handler may attach or detach timers
+      handler();
+    } else {
+      break;
+    }
+  }
+  clockMicros = target;
+}
+
+void setPin(uint8_t pin, uint8_t level) {
+  drive(pin, true, level);
+}
+
+void schedulePin(uint8_t pin, uint64_t atMicros, uint8_t level) {
+  scheduledLevel entry = {pin, level, 0, false};
+  schedule().insert(std::make_pair(atMicros, entry));
+}
+
+void setSwitch(uint8_t pinA, uint8_t pinB, bool closed) {
+  closeSwitch(pinA, pinB, closed);
+}
+
+void scheduleSwitch(uint8_t pinA, uint8_t pinB, uint64_t atMicros, bool closed) {
+  scheduledLevel entry = {pinA, (uint8_t)(closed ? HIGH : LOW), pinB, true};
+  schedule().insert(std::make_pair(atMicros, entry));
+}
+
+void releasePin(uint8_t pin) {
+  drive(pin, false, LOW);
+}
+
+bool loadScript(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL)
+    return false;
+
+  char line[128];
+  int lineNumber = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    lineNumber++;
+    char *comment = strchr(line, '#');
+    if (comment != NULL)
+      *comment = '\0';
+
+    double ms;
+    unsigned pin, otherPin, level;
+    char extra;
+    int fields = sscanf(line, " %lf %u-%u %u %c", &ms, &pin, &otherPin, &level, &extra);
+    if (fields == 4 && ms >= 0 && pin < NUM_DIGITAL_PINS && otherPin < NUM_DIGITAL_PINS) {
+      scheduleSwitch(pin, otherPin, (uint64_t)(ms * 1000.0 + 0.5), level != 0);
+      continue;
+    }
+    fields = sscanf(line, " %lf %u %u %c", &ms, &pin, &level, &extra);
+    if (fields <= 0)
+      continue;  // blank or comment only
+    if (fields != 3 || ms < 0 || pin >= NUM_DIGITAL_PINS) {
+      fprintf(stderr, "%s:%d: expected \"<time in ms> <pin> <level>\" or \"<pin>-<pin>\"\n", path,
+              lineNumber);
+      ok = false;
+      continue;
+    }
+    schedulePin(pin, (uint64_t)(ms * 1000.0 + 0.5), level ? HIGH : LOW);
+  }
+  fclose(file);
+  return ok;
+}
+
+uint8_t outputLevel(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS ? pins[pin].output : LOW;
+}
+
+uint8_t modeOf(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS ? pins[pin].mode : INPUT;
+}
+
+void onPinChange(uint8_t pin, pinHandler handler) {
+  if (pin < NUM_DIGITAL_PINS)
+    pins[pin].changeHandler = handler;
+}
+
+void attachTimer(uint32_t periodMicros, timerHandler handler) {
+  detachTimer(handler);
+  periodicTimer timer = {periodMicros ? periodMicros : 1, clockMicros + periodMicros, handler};
+  timers().push_back(timer);
+}
+
+void detachTimer(timerHandler handler) {
+  std::vector<periodicTimer> &list = timers();
+  for (size_t i = 0; i < list.size(); i++) {
+    if (list[i].handler == handler) {
+      list.erase(list.begin() + i);
+      return;
+    }
+  }
+}
+
+void onPinWrite(pinHandler handler) {
+  writeHandler = handler;
+}
+
+void setTrace(bool enabled) {
+  trace = enabled;
+}
+
+}  // namespace nativeHal
@@ -0,0 +1,55 @@
+// kept apart from the core so programs that define their own main() link neither main() nor the
+// runner, and don't need setup() and loop()
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#include <stdio.h>
+
+namespace nativeHal {
+
+int run(int argc, char **argv) {
+  double runMs = 10000;
+  unsigned long loopMicros = 10;
+  const char *eepromPath = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--run-ms") == 0 && hasValue) {
+      runMs = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--loop-us") == 0 && hasValue) {
+      loopMicros = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--script") == 0 && hasValue) {
+      if (!loadScript(argv[++i]))
+        return 1;
+    } else if (strcmp(argv[i], "--eeprom") == 0 && hasValue) {
+      eepromPath = argv[++i];
+      if (!loadEeprom(eepromPath))
+        return 1;
+    } else if (strcmp(argv[i], "--trace") == 0) {
+      setTrace(true);
+    } else {
+      fprintf(stderr,
+              "usage: %s [--run-ms ms] [--loop-us us] [--script file] [--eeprom file] [--trace]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  uint64_t end = now() + (uint64_t)(runMs * 1000.0);
+  setup();
+  while (now() < end) {
+    loop();
+    advance(loopMicros);
+  }
+  if (eepromPath != NULL && !saveEeprom(eepromPath)) {
+    fprintf(stderr, "%s: could not save the EEPROM image\n", eepromPath);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace nativeHal
+
+int main(int argc, char **argv) {
+  return nativeHal::run(argc, argv);
+}
@@ -0,0 +1,76 @@
+#include <EEPROM.h>
+
+#include <stdio.h>
+
+EEPROMClass EEPROM;
+
+namespace {
+
+// constant initialized to zero, so the erased state is set up on first use
+uint8_t cells[E2END + 1];
+unsigned long writes[E2END + 1];
+bool initialized = false;
+
+void initialize(void) {
+  if (!initialized)
+    nativeHal::eraseEeprom();
+}
+
+bool valid(int address) {
+  return address >= 0 && address <= E2END;
+}
+
+}  // namespace
+
+uint8_t EEPROMClass::read(int address) {
+  initialize();
+  return valid(address) ? cells[address] : 0;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  initialize();
+  if (!valid(address))
+    return;
+  cells[address] = value;
+  writes[address]++;
+}
+
+void EEPROMClass::update(int address, uint8_t value) {
+  if (read(address) != value)
+    write(address, value);
+}
+
+namespace nativeHal {
+
+void eraseEeprom(void) {
+  memset(cells, 0xFF, sizeof(cells));
+  memset(writes, 0, sizeof(writes));
+  initialized = true;
+}
+
+bool loadEeprom(const char *path) {
+  eraseEeprom();
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return true;  // nothing saved yet
+  bool ok = fread(cells, 1, sizeof(cells), file) == sizeof(cells);
+  fclose(file);
+  if (!ok)
+    fprintf(stderr, "%s: expected a %u byte EEPROM image\n", path, (unsigned)sizeof(cells));
+  return ok;
+}
+
+bool saveEeprom(const char *path) {
+  initialize();
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+    return false;
+  bool ok = fwrite(cells, 1, sizeof(cells), file) == sizeof(cells);
+  return fclose(file) == 0 && ok;
+}
+
+unsigned long eepromWrites(int address) {
+  return valid(address) ? writes[address] : 0;
+}
+
+}  // namespace nativeHal
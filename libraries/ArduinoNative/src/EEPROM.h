@@ -0,0 +1,67 @@
+/*
+  EEPROM.h (native)
+
+  The byte-wise interface of the Arduino EEPROM library on the host, backed by 1 KB of memory that
+  starts erased (every byte 0xFF) like a new ATmega328P. The contents survive nativeHal::reset(),
+  as a real EEPROM survives a reset, and the runner's --eeprom option loads them from a file before
+  setup() and saves them back at the end of the run, so state can be carried across runs.
+
+  Every write is counted per address, so wear can be measured with nativeHal::eepromWrites().
+  update() only writes when the value differs, as on the board.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <Arduino.h>
+
+#define E2END 0x3FF  // last EEPROM address of an ATmega328P
+
+class EEPROMClass {
+ public:
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  void update(int address, uint8_t value);
+  uint16_t length(void) { return E2END + 1; }
+
+  template <typename T>
+  T &get(int address, T &value) {
+    uint8_t *bytes = (uint8_t *)&value;
+    for (size_t i = 0; i < sizeof(T); i++)
+      bytes[i] = read(address + i);
+    return value;
+  }
+
+  template <typename T>
+  const T &put(int address, const T &value) {
+    const uint8_t *bytes = (const uint8_t *)&value;
+    for (size_t i = 0; i < sizeof(T); i++)
+      update(address + i, bytes[i]);
+    return value;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+namespace nativeHal {
+
+// erase every byte to 0xFF and clear the write counts
+void eraseEeprom(void);
+
+// load or save the whole EEPROM image, a missing file loads as erased
+bool loadEeprom(const char *path);
+bool saveEeprom(const char *path);
+
+// writes made to an address since the EEPROM was erased or loaded
+unsigned long eepromWrites(int address);
+
+}  // namespace nativeHal
+
+#endif
@@ -0,0 +1,46 @@
+#include <Arduino.h>
+
+#include <poll.h>
+#include <stdio.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+
+void HardwareSerial::attach(int inFd, int outFd) {
+  inputFd = inFd;
+  outputFd = outFd;
+  peeked = -1;
+}
+
+int HardwareSerial::available(void) {
+  if (peeked >= 0)
+    return 1;
+  peek();
+  return peeked >= 0 ? 1 : 0;
+}
+
+int HardwareSerial::peek(void) {
+  if (peeked >= 0 || inputFd < 0)
+    return peeked;
+  struct pollfd pending = {inputFd, POLLIN, 0};
+  if (poll(&pending, 1, 0) <= 0 || !(pending.revents & POLLIN))
+    return -1;
+  uint8_t c;
+  if (::read(inputFd, &c, 1) == 1)
+    peeked = c;
+  return peeked;
+}
+
+int HardwareSerial::read(void) {
+  int c = peek();
+  peeked = -1;
+  return c;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  if (outputFd < 0)
+    return 0;
+  fflush(stdout);  // keep the order of anything printed to stdout directly, such as the trace
+  ssize_t written = ::write(outputFd, buffer, size);
+  return written > 0 ? written : 0;
+}
@@ -0,0 +1,39 @@
+#include <Arduino.h>
+
+#include <stdio.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t written = 0;
+  while (size-- > 0)
+    written += write(*buffer++);
+  return written;
+}
+
+size_t Print::print(long n, int base) {
+  if (base == DEC) {
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", n);
+    return write(text);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  if (base < 2)
+    base = DEC;
+  char text[8 * sizeof(n) + 1];
+  char *digit = &text[sizeof(text) - 1];
+  *digit = '\0';
+  do {
+    unsigned long d = n % base;
+    *--digit = d < 10 ? '0' + d : 'A' + d - 10;
+    n /= base;
+  } while (n > 0);
+  return write(digit);
+}
+
+size_t Print::print(double n, int digits) {
+  char text[48];
+  snprintf(text, sizeof(text), "%.*f", digits, n);
+  return write(text);
+}
@@ -0,0 +1,254 @@
+/*
+  cooperativeScheduler.h
+
+  A small cooperative scheduler for periodic and one-shot tasks, replacing the hand-rolled
+  "millis() - last >= interval" checks that sketches otherwise repeat for every timer. Capacity is
+  fixed at compile time and nothing is allocated on the heap. Pending tasks are kept in a binary
+  min-heap ordered by deadline, so run() only looks at the earliest deadline when nothing is due and
+  the time until the next task is known at any moment. That lets a sketch sleep until it instead of
+  polling every timer on every pass of loop().
+
+  cooperativeScheduler<4> tasks;  // room for four pending tasks
+
+  void blink(void *context) { ... }
+
+  void setup() {
+    tasks.every(500, blink);           // call blink() every 500 ms
+    tasks.after(10000, timeout, ctx);  // call timeout(ctx) once, 10 s from now
+  }
+
+  void loop() {
+    tasks.run(millis());
+    tasks.sleepUntilNextTask(millis());
+  }
+
+  Periodic deadlines advance by whole periods from the first deadline rather than from the time a
+  task happened to run, so late runs don't accumulate drift. When a task falls more than a period
+  behind, the missed runs are skipped instead of being run back to back. The largest lateness seen
+  is kept as a measure of jitter.
+
+  Tasks are identified by the handle their scheduling call returns, or noTask when the scheduler is
+  full. A one-shot task's handle is released once the task runs, so sketches that keep handles should
+  reset them to noTask from the task itself. Callbacks may schedule and cancel tasks, including
+  themselves.
+
+  Deadlines use wrap-safe comparisons, so the scheduler keeps working when millis() rolls over as
+  long as no task is scheduled more than about 24 days ahead.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef cooperativeScheduler_h
+#define cooperativeScheduler_h
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
+
+// idle the MCU until the next interrupt, for sketches that keep their own deadlines
+inline void sleepUntilInterrupt(void) {
+#if defined(__AVR__)
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+#elif defined(ARDUINO_NATIVE)
+  nativeHal::advance(1000 - nativeHal::now() % 1000);  // the next timer 0 tick
+#endif
+}
+
+typedef void (*taskCallback)(void *context);
+typedef uint8_t taskHandle;
+
+const taskHandle noTask = 0xFF;
+const unsigned long noDeadline = 0xFFFFFFFFUL;
+
+template <uint8_t Capacity>
+class cooperativeScheduler {
+  static_assert(Capacity > 0 && Capacity < noTask, "scheduler capacity must be between 1 and 254");
+
+ public:
+  cooperativeScheduler() : pending(0), lateness(0), ranAt(0) {
+    for (uint8_t i = 0; i < Capacity; i++)
+      tasks[i].callback = NULL;
+  }
+
+  // run a task once after a delay
+  taskHandle after(unsigned long delay, taskCallback callback, void *context = NULL) {
+    return schedule(delay, 0, callback, context);
+  }
+
+  // run a task every period, the first time one period from now
+  taskHandle every(unsigned long period, taskCallback callback, void *context = NULL) {
+    return schedule(period, period, callback, context);
+  }
+
+  // run a task after a delay and then every period, or only once when the period is zero
+  taskHandle schedule(unsigned long delay, unsigned long period, taskCallback callback,
+                      void *context = NULL) {
+    return schedule(millis(), delay, period, callback, context);
+  }
+
+  taskHandle schedule(unsigned long now, unsigned long delay, unsigned long period,
+                      taskCallback callback, void *context) {
+    if (callback == NULL)
+      return noTask;
+    uint8_t slot = 0;
+    while (slot < Capacity && tasks[slot].callback != NULL)
+      slot++;
+    if (slot == Capacity)
+      return noTask;
+
+    task &t = tasks[slot];
+    t.deadline = now + delay;
+    t.period = period;
+    t.callback = callback;
+    t.context = context;
+    heap[pending] = slot;
+    t.heapIndex = pending++;
+    siftUp(t.heapIndex);
+    return slot;
+  }
+
+  // stop a pending task, the handle is set to noTask
+  void cancel(taskHandle &handle) {
+    if (isScheduled(handle)) {
+      remove(tasks[handle].heapIndex);
+      tasks[handle].callback = NULL;
+    }
+    handle = noTask;
+  }
+
+  bool isScheduled(taskHandle handle) const {
+    return handle < Capacity && tasks[handle].callback != NULL;
+  }
+
+  // run every task that is due, returns how many ran
+  uint8_t run(unsigned long now) {
+    uint8_t ran = 0;
+    ranAt = now;
+    // periodic tasks are always rescheduled past now, the bound stops tasks that keep scheduling
+    // new zero-delay tasks from holding on to loop()
+    while (pending > 0 && ran < Capacity && isDue(tasks[heap[0]].deadline, now)) {
+      uint8_t slot = heap[0];
+      task &t = tasks[slot];
+      unsigned long late = now - t.deadline;
+      if (late > lateness)
+        lateness = late;
+
+      taskCallback callback = t.callback;
+      void *context = t.context;
+      if (t.period == 0) {
+        remove(0);
+        t.callback = NULL;
+      } else {
+        // stay in phase with the first deadline, skipping runs that were missed entirely
+        t.deadline += t.period * (late / t.period + 1);
+        siftDown(0);
+      }
+      callback(context);
+      ran++;
+    }
+    return ran;
+  }
+
+  uint8_t run(void) { return run(millis()); }
+
+  // time until the earliest pending task is due, zero if one is due now, noDeadline if none
+  unsigned long timeUntilNextTask(unsigned long now) const {
+    if (pending == 0)
+      return noDeadline;
+    unsigned long deadline = tasks[heap[0]].deadline;
+    return isDue(deadline, now) ? 0 : deadline - now;
+  }
+
+  // idle the MCU until the next interrupt when no task is due, timer 0 wakes it within a millisecond
+  // so polled inputs keep being read
+  void sleepUntilNextTask(unsigned long now) {
+    if (timeUntilNextTask(now) == 0)
+      return;
+    sleepUntilInterrupt();
+  }
+
+  uint8_t pendingTasks(void) const { return pending; }
+
+  // the time the last run() was given, for tasks that need to know when they ran
+  unsigned long lastRun(void) const { return ranAt; }
+
+  // the latest any task has run after its deadline since the last reset
+  unsigned long maxLateness(void) const { return lateness; }
+  void resetLateness(void) { lateness = 0; }
+
+ private:
+  struct task {
+    unsigned long deadline;
+    unsigned long period;  // zero for one-shot tasks
+    taskCallback callback;  // NULL while the slot is free
+    void *context;
+    uint8_t heapIndex;
+  };
+
+  task tasks[Capacity];
+  uint8_t heap[Capacity];  // task slots ordered as a min-heap on deadline
+  uint8_t pending;
+  unsigned long lateness;
+  unsigned long ranAt;
+
+  static bool isDue(unsigned long deadline, unsigned long now) { return (long)(now - deadline) >= 0; }
+
+  bool earlier(uint8_t a, uint8_t b) const {
+    return (long)(tasks[heap[a]].deadline - tasks[heap[b]].deadline) < 0;
+  }
+
+  void swap(uint8_t a, uint8_t b) {
+    uint8_t slot = heap[a];
+    heap[a] = heap[b];
+    heap[b] = slot;
+    tasks[heap[a]].heapIndex = a;
+    tasks[heap[b]].heapIndex = b;
+  }
+
+  void siftUp(uint8_t i) {
+    while (i > 0) {
+      uint8_t parent = (i - 1) / 2;
+      if (!earlier(i, parent))
+        break;
+      swap(i, parent);
+      i = parent;
+    }
+  }
+
+  void siftDown(uint8_t i) {
+    for (;;) {
+      uint8_t left = 2 * i + 1;
+      uint8_t right = left + 1;
+      uint8_t smallest = i;
+      if (left < pending && earlier(left, smallest))
+        smallest = left;
+      if (right < pending && earlier(right, smallest))
+        smallest = right;
+      if (smallest == i)
+        return;
+      swap(i, smallest);
+      i = smallest;
+    }
+  }
+
+  void remove(uint8_t i) {
+    pending--;
+    if (i == pending)
+      return;
+    swap(i, pending);
+    siftDown(i);
+    siftUp(i);
+  }
+};
+
+#endif
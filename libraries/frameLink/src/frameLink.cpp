@@ -0,0 +1,238 @@
+#include <frameLink.h>
+
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#endif
+
+static const uint8_t rxMask = FRAME_LINK_RX_SIZE - 1;
+static const uint8_t txMask = FRAME_LINK_TX_SIZE - 1;
+
+// positions run freely and are masked into the rings, so head - tail is the bytes held
+static uint8_t rxBuffer[FRAME_LINK_RX_SIZE];
+static volatile uint8_t rxHead;  // written by the receive interrupt
+static volatile uint8_t rxTail;
+static uint8_t txBuffer[FRAME_LINK_TX_SIZE];
+static volatile uint8_t txHead;
+static volatile uint8_t txTail;  // written by the transmit interrupt
+
+static bool holding;       // receive() returned a frame that hasn't been released
+static uint8_t heldSize;   // bytes the held frame takes in the ring
+static bool writerOpen;
+static uint8_t waitHead;   // receive ring head when an unfinished frame was last seen to grow
+static uint8_t waitTail;
+static unsigned long waitSince;
+static frameLinkStats counts;
+static volatile uint16_t overruns;
+
+#ifdef __AVR__
+#if defined(USART_RX_vect)
+#define FRAME_LINK_RX_VECT USART_RX_vect
+#define FRAME_LINK_UDRE_VECT USART_UDRE_vect
+#else
+#define FRAME_LINK_RX_VECT USART0_RX_vect
+#define FRAME_LINK_UDRE_VECT USART0_UDRE_vect
+#endif
+
+ISR(FRAME_LINK_RX_VECT) {
+  uint8_t c = UDR0;  // read even when there is no room, to clear the interrupt
+  uint8_t head = rxHead;
+  if ((uint8_t)(head - rxTail) == FRAME_LINK_RX_SIZE) {
+    overruns++;
+    return;
+  }
+  rxBuffer[head & rxMask] = c;
+  rxHead = head + 1;
+}
+
+ISR(FRAME_LINK_UDRE_VECT) {
+  uint8_t tail = txTail;
+  if (tail == txHead) {
+    UCSR0B &= ~_BV(UDRIE0);  // nothing left, wait for the next send()
+    return;
+  }
+  UDR0 = txBuffer[tail & txMask];
+  txTail = tail + 1;
+}
+
+void frameLink::begin(unsigned long baud) {
+  uint8_t oldSREG = SREG;
+  cli();
+  UCSR0A = _BV(U2X0);  // double speed halves the baud rate error at the usual rates
+  UBRR0 = (F_CPU / 4 / baud - 1) / 2;
+  UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);  // 8 data bits, no parity, 1 stop bit
+  UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+  SREG = oldSREG;
+}
+
+// start the transmit interrupt on the bytes just added
+static void startSending(void) {
+  uint8_t oldSREG = SREG;
+  cli();
+  UCSR0B |= _BV(UDRIE0);
+  SREG = oldSREG;
+}
+
+// the receive interrupt fills the ring by itself
+static void pump(void) {}
+#else
+void frameLink::begin(unsigned long baud) {
+  Serial.begin(baud);
+}
+
+// Serial stands in for the UART, moved through the rings here instead of by interrupts; bytes are
+// left waiting in Serial while the ring is full, so none are lost
+static void pump(void) {
+  uint8_t head = rxHead;
+  while ((uint8_t)(head - rxTail) < FRAME_LINK_RX_SIZE && Serial.available() > 0) {
+    rxBuffer[head & rxMask] = Serial.read();
+    head++;
+  }
+  rxHead = head;
+}
+
+static void startSending(void) {
+  while (txTail != txHead) {
+    uint8_t tail = txTail;
+    uint8_t run = txHead - tail;
+    uint8_t untilWrap = FRAME_LINK_TX_SIZE - (tail & txMask);
+    if (run > untilWrap)
+      run = untilWrap;
+    Serial.write(&txBuffer[tail & txMask], run);
+    txTail = tail + run;
+  }
+}
+#endif
+
+uint8_t frameView::operator[](uint8_t index) const {
+  return rxBuffer[(uint8_t)(start + index) & rxMask];
+}
+
+bool frameLink::receive(frameView &frame) {
+  pump();
+  for (;;) {
+    uint8_t tail = rxTail;
+    uint8_t held = rxHead - tail;
+    if (held == 0)
+      return false;
+    if (rxBuffer[tail & rxMask] != frameSync) {
+      rxTail = tail + 1;
+      continue;
+    }
+
+    bool bad = false;
+    if (held >= 2) {
+      uint8_t length = rxBuffer[(uint8_t)(tail + 1) & rxMask];
+      if (length > frameMaxRxPayload) {
+        bad = true;
+      } else if (held >= length + frameOverhead) {
+        uint8_t crc = frameCrc8(0, length);
+        for (uint8_t i = 0; i < length; i++)
+          crc = frameCrc8(crc, rxBuffer[(uint8_t)(tail + 2 + i) & rxMask]);
+        if (crc == rxBuffer[(uint8_t)(tail + 2 + length) & rxMask]) {
+          if (!holding)
+            counts.frames++;
+          holding = true;
+          heldSize = length + frameOverhead;
+          frame.start = tail + 2;
+          frame.size = length;
+          return true;
+        }
+        bad = true;
+      }
+    }
+
+    if (!bad) {
+      // unfinished, give up on it once nothing has arrived for a while
+      uint8_t head = rxHead;
+      if (tail != waitTail || head != waitHead) {
+        waitTail = tail;
+        waitHead = head;
+        waitSince = millis();
+        return false;
+      }
+      if (millis() - waitSince < FRAME_LINK_TIMEOUT)
+        return false;
+    }
+    // look for the next sync byte from just past this one
+    counts.badFrames++;
+    rxTail = tail + 1;
+  }
+}
+
+void frameLink::release(void) {
+  if (!holding)
+    return;
+  holding = false;
+  rxTail = rxTail + heldSize;
+}
+
+uint8_t frameLink::sending(void) {
+  return txHead - txTail;
+}
+
+frameLinkStats frameLink::stats(void) {
+  frameLinkStats s = counts;
+#ifdef __AVR__
+  uint8_t oldSREG = SREG;
+  cli();
+  s.overruns = overruns;
+  SREG = oldSREG;
+#else
+  s.overruns = overruns;
+#endif
+  return s;
+}
+
+frameWriter::frameWriter(uint8_t capacity) : capacity(capacity), size(0), overflow(false) {
+  start = txHead;
+  uint8_t room = FRAME_LINK_TX_SIZE - (uint8_t)(start - txTail);
+  reserved = !writerOpen && capacity <= frameMaxTxPayload && room >= capacity + frameOverhead;
+  if (reserved)
+    writerOpen = true;
+}
+
+frameWriter::~frameWriter() {
+  if (reserved)
+    writerOpen = false;  // abandoned without sending
+}
+
+void frameWriter::put(uint8_t value) {
+  if (!reserved)
+    return;
+  if (size == capacity) {
+    overflow = true;
+    return;
+  }
+  txBuffer[(uint8_t)(start + 2 + size) & txMask] = value;
+  size++;
+}
+
+void frameWriter::put16(uint16_t value) {
+  put(value);
+  put(value >> 8);
+}
+
+void frameWriter::put32(uint32_t value) {
+  put16(value);
+  put16(value >> 16);
+}
+
+bool frameWriter::send(void) {
+  if (!reserved)
+    return false;
+  reserved = false;
+  writerOpen = false;
+  if (overflow)
+    return false;
+
+  txBuffer[start & txMask] = frameSync;
+  txBuffer[(uint8_t)(start + 1) & txMask] = size;
+  uint8_t crc = frameCrc8(0, size);
+  for (uint8_t i = 0; i < size; i++)
+    crc = frameCrc8(crc, txBuffer[(uint8_t)(start + 2 + i) & txMask]);
+  txBuffer[(uint8_t)(start + 2 + size) & txMask] = crc;
+
+  txHead = start + size + frameOverhead;  // the interrupt only sees the frame once it is whole
+  startSending();
+  return true;
+}
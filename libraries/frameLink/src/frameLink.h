@@ -0,0 +1,160 @@
+/*
+  frameLink.h
+
+  A binary message link over the UART that never makes the sketch wait. Bytes are moved between
+  the UART and two ring buffers by interrupts; received frames are checked and read where they lie
+  in the receive ring, and replies are written straight into the transmit ring, so a message is
+  never copied between buffers and no call blocks on the UART.
+
+  frameLink::begin(115200);
+
+  frameView request;
+  if (frameLink::receive(request)) {
+    frameWriter reply(8);  // room for up to 8 payload bytes
+    if (!reply.ready())
+      return;              // transmit ring full, try the same request again on the next loop
+    reply.put(request[0] | 0x80);
+    reply.put32(millis());
+    reply.send();
+    frameLink::release();  // done with the request, its bytes can be reused
+  }
+
+  On the wire a frame is a sync byte (0xA5), the payload length, the payload and a CRC-8
+  (polynomial 0x07) of the length and payload. A receiver that loses its place, or sees a wrong
+  checksum, a length too long for the ring or a frame left unfinished for FRAME_LINK_TIMEOUT
+  milliseconds, skips one byte and looks for the next sync byte, so it finds the next good frame
+  even when sync bytes turn up inside payloads. Multi-byte values are little-endian.
+
+  The rings hold FRAME_LINK_RX_SIZE and FRAME_LINK_TX_SIZE bytes (64 each unless defined
+  otherwise, powers of two up to 128), which limits a payload to three bytes less. Bytes arriving
+  while the receive ring is full are lost and counted, so requests should be answered before more
+  are sent. A received frame stays at the head of the ring until release() is called, and a reply
+  takes room in the transmit ring only once send() is called, so a sketch can answer a request
+  whenever there is room for the reply without holding anything in RAM of its own.
+
+  On AVR boards the link drives USART0 with its own interrupts and Serial can't be used alongside
+  it. In the native build it reads and writes Serial, which the runner connects to its standard
+  input and output and programs can attach to a pseudo terminal. Bytes are only read from Serial
+  while the receive ring has room, so none are lost there.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef frameLink_h
+#define frameLink_h
+
+#include <Arduino.h>
+
+#ifndef FRAME_LINK_RX_SIZE
+#define FRAME_LINK_RX_SIZE 64
+#endif
+
+#ifndef FRAME_LINK_TX_SIZE
+#define FRAME_LINK_TX_SIZE 64
+#endif
+
+#ifndef FRAME_LINK_TIMEOUT
+#define FRAME_LINK_TIMEOUT 20
+#endif
+
+static_assert(FRAME_LINK_RX_SIZE >= 8 && FRAME_LINK_RX_SIZE <= 128 &&
+                  (FRAME_LINK_RX_SIZE & (FRAME_LINK_RX_SIZE - 1)) == 0,
+              "FRAME_LINK_RX_SIZE must be a power of two from 8 to 128");
+static_assert(FRAME_LINK_TX_SIZE >= 8 && FRAME_LINK_TX_SIZE <= 128 &&
+                  (FRAME_LINK_TX_SIZE & (FRAME_LINK_TX_SIZE - 1)) == 0,
+              "FRAME_LINK_TX_SIZE must be a power of two from 8 to 128");
+
+const uint8_t frameSync = 0xA5;
+const uint8_t frameOverhead = 3;  // sync, length and checksum
+
+// longest payload that can be received, and sent
+const uint8_t frameMaxRxPayload = FRAME_LINK_RX_SIZE - frameOverhead;
+const uint8_t frameMaxTxPayload = FRAME_LINK_TX_SIZE - frameOverhead;
+
+// one step of the frame checksum, for building frames elsewhere such as on a host
+inline uint8_t frameCrc8(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; i++)
+    crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x07 : (uint8_t)(crc << 1);
+  return crc;
+}
+
+struct frameLinkStats {
+  uint16_t frames;     // good frames received
+  uint16_t badFrames;  // frames dropped for their checksum, length or timeout
+  uint16_t overruns;   // bytes lost to a full receive ring
+};
+
+class frameView;
+namespace frameLink {
+bool receive(frameView &frame);
+}
+
+// the payload of a received frame, read in place; only valid until frameLink::release()
+class frameView {
+ public:
+  frameView() : start(0), size(0) {}
+
+  uint8_t length(void) const { return size; }
+  uint8_t operator[](uint8_t index) const;
+  uint16_t u16(uint8_t index) const { return (*this)[index] | ((*this)[index + 1] << 8); }
+  uint32_t u32(uint8_t index) const { return u16(index) | ((uint32_t)u16(index + 2) << 16); }
+
+ private:
+  friend bool frameLink::receive(frameView &frame);
+  uint8_t start;  // ring position of the first payload byte
+  uint8_t size;
+};
+
+// a frame built in place in the transmit ring, sent by send(); only one may be open at a time
+class frameWriter {
+ public:
+  // reserve room for a payload of up to capacity bytes
+  explicit frameWriter(uint8_t capacity);
+  ~frameWriter();
+
+  // the room was reserved; otherwise puts are ignored and send() sends nothing
+  bool ready(void) const { return reserved; }
+
+  void put(uint8_t value);
+  void put16(uint16_t value);
+  void put32(uint32_t value);
+
+  uint8_t length(void) const { return size; }
+  uint8_t room(void) const { return reserved ? capacity - size : 0; }
+
+  // more was put than the capacity, send() would send nothing
+  bool overflowed(void) const { return overflow; }
+
+  // add the header and checksum and hand the frame to the UART
+  bool send(void);
+
+ private:
+  uint8_t start;  // ring position of the sync byte
+  uint8_t capacity;
+  uint8_t size;
+  bool reserved;
+  bool overflow;
+};
+
+namespace frameLink {
+void begin(unsigned long baud);
+
+// the oldest complete frame, the same one until it is released
+bool receive(frameView &frame);
+
+// drop the frame receive() returned
+void release(void);
+
+// bytes waiting to be sent
+uint8_t sending(void);
+
+frameLinkStats stats(void);
+}  // namespace frameLink
+
+#endif
@@ -0,0 +1,334 @@
+#include <ledPanel.h>
+
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#endif
+
+// a bit plane has a byte per port or shift register
+static const uint8_t chainBytes = (LED_PANEL_CHANNELS + 7) / 8;
+static const uint8_t portSlots = LED_PANEL_CHANNELS < 11 ? LED_PANEL_CHANNELS : 11;
+static const uint8_t planeBytes = chainBytes > portSlots ? chainBytes : portSlots;
+
+// blinks shorter than two frames would only flicker
+static const uint16_t shortestPeriod = 2 * LED_PANEL_FRAME_MS;
+
+struct panelChannel {
+  uint16_t period;    // zero while holding a brightness
+  uint16_t onTime;    // milliseconds lit at the start of each period
+  uint16_t position;  // milliseconds into the period
+  uint8_t brightness;
+  bool lit;
+  uint8_t byte;  // where the LED sits in a bit plane
+  uint8_t bit;
+#ifndef __AVR__
+  uint8_t pin;
+  bool shown;
+#endif
+};
+
+static panelChannel channels[LED_PANEL_CHANNELS];
+static uint8_t channelCount;
+static uint8_t bytesUsed;
+static uint8_t planes[8][planeBytes];  // bit n of every LED's brightness while it is lit
+static volatile uint32_t frameCount;
+static bool began;
+
+#ifdef __AVR__
+static volatile uint8_t *portRegister[planeBytes];
+static uint8_t portMask[planeBytes];
+static volatile uint8_t *latchRegister;  // NULL when driving pins
+static uint8_t latchBit;
+static uint8_t slot;  // 0 is the blank unit, 1 to 8 the planes of bits 0 to 7
+#endif
+
+// the next frame's position in a period of at least two frames
+static uint16_t nextPosition(uint16_t position, uint16_t period) {
+  if (position >= period - LED_PANEL_FRAME_MS)
+    return position - (period - LED_PANEL_FRAME_MS);
+  return position + LED_PANEL_FRAME_MS;
+}
+
+// put a channel's brightness, or nothing while it is dark, into the bit planes
+static void paint(const panelChannel &c) {
+  uint8_t shown = c.lit ? c.brightness : 0;
+  for (uint8_t b = 0; b < 8; b++, shown >>= 1) {
+    if (shown & 1)
+      planes[b][c.byte] |= c.bit;
+    else
+      planes[b][c.byte] &= ~c.bit;
+  }
+}
+
+#ifndef __AVR__
+// without modulation a pin shows whether its LED is lit at all
+static void show(panelChannel &c) {
+  bool level = c.lit && c.brightness != 0;
+  if (level != c.shown) {
+    c.shown = level;
+    digitalWrite(c.pin, level ? HIGH : LOW);
+  }
+}
+#endif
+
+// one frame on, with interrupts disabled; every blink counts from here
+static void advanceFrame(void) {
+  frameCount++;
+  for (uint8_t i = 0; i < channelCount; i++) {
+    panelChannel &c = channels[i];
+    if (c.period == 0)
+      continue;
+    c.position = nextPosition(c.position, c.period);
+    bool lit = c.position < c.onTime;
+    if (lit != c.lit) {
+      c.lit = lit;
+      paint(c);
+    }
+  }
+}
+
+#ifdef __AVR__
+
+#if F_CPU != 16000000L && F_CPU != 8000000L
+#error "ledPanel needs a 16 or 8 MHz clock for an exact frame"
+#endif
+
+// 256 units make a frame
+static const uint16_t unitCounts = F_CPU / 1000 * LED_PANEL_FRAME_MS / 256;
+
+// timer counts of each slot, the blank unit and then 2^n units for bit n
+static const uint16_t slotCounts[9] PROGMEM = {
+    unitCounts,      unitCounts,      2 * unitCounts,  4 * unitCounts,  8 * unitCounts,
+    16 * unitCounts, 32 * unitCounts, 64 * unitCounts, 128 * unitCounts};
+
+// the far end of the chain first, a NULL plane shifts the blank unit
+static inline void shiftPlane(const uint8_t *bits) {
+  for (uint8_t i = bytesUsed; i-- > 0;) {
+    SPDR = bits != NULL ? bits[i] : 0;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+  }
+}
+
+// Timer1 runs free and every slot ends a fixed count after the one before it, so the frames keep
+// to the clock however late an interrupt is served
+ISR(TIMER1_COMPA_vect) {
+  uint16_t slotStart = OCR1A;  // when the slot starting now was due
+  for (;;) {
+    uint8_t showing = slot;
+    uint16_t length = pgm_read_word(slotCounts + showing);
+    OCR1A = slotStart + length;
+
+    if (latchRegister != NULL) {
+      // show what was shifted in during the last slot and load the next one behind it
+      *latchRegister |= latchBit;
+      *latchRegister &= ~latchBit;
+      shiftPlane(showing < 8 ? planes[showing] : NULL);
+    } else {
+      for (uint8_t p = 0; p < bytesUsed; p++) {
+        uint8_t bits = showing != 0 ? planes[showing - 1][p] : 0;
+        *portRegister[p] = (*portRegister[p] & ~portMask[p]) | bits;
+      }
+    }
+
+    // the longest slot has time for the blinks, which show from the next frame on
+    if (showing == 8) {
+      advanceFrame();
+      slot = 0;
+    } else {
+      slot = showing + 1;
+    }
+
+    // a slot that ran out while the interrupt was late is cut short instead of waiting a whole
+    // turn of the timer for its compare match
+    if ((uint16_t)(TCNT1 - slotStart) < length)
+      return;
+    slotStart += length;
+    TIFR1 = _BV(OCF1A);
+  }
+}
+
+static void start(void) {
+  slot = 0;
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);         // normal mode, counting freely at clk / 1
+  OCR1A = TCNT1 + unitCounts;  // a dark unit before the first frame
+  TIFR1 = _BV(OCF1A);
+  TIMSK1 |= _BV(OCIE1A);
+}
+
+#else
+
+static void frameTick(void) {
+  advanceFrame();
+  for (uint8_t i = 0; i < channelCount; i++)
+    show(channels[i]);
+}
+
+static void start(void) {
+  nativeHal::attachTimer(LED_PANEL_FRAME_MS * 1000UL, frameTick);
+}
+
+#endif
+
+// holds the interrupt off while a channel changes; native timers only fire while the clock advances
+class panelGuard {
+ public:
+#ifdef __AVR__
+  panelGuard() : oldSREG(SREG) { cli(); }
+  ~panelGuard() { SREG = oldSREG; }
+
+ private:
+  uint8_t oldSREG;
+#else
+  panelGuard() {}
+  ~panelGuard() {}
+#endif
+};
+
+static void clearChannel(panelChannel &c) {
+  c.period = 0;
+  c.onTime = 0;
+  c.position = 0;
+  c.brightness = 0;
+  c.lit = false;
+}
+
+bool ledPanel::beginPins(const uint8_t pins[], uint8_t count) {
+  if (began || count == 0 || count > LED_PANEL_CHANNELS)
+    return false;
+
+  for (uint8_t i = 0; i < count; i++) {
+    panelChannel &c = channels[i];
+    clearChannel(c);
+#ifdef __AVR__
+    uint8_t port = digitalPinToPort(pins[i]);
+    if (port == NOT_A_PIN)
+      return false;
+    volatile uint8_t *reg = portOutputRegister(port);
+    uint8_t p = 0;
+    while (p < bytesUsed && portRegister[p] != reg)
+      p++;
+    if (p == bytesUsed) {
+      portRegister[bytesUsed++] = reg;
+      portMask[p] = 0;
+    }
+    c.byte = p;
+    c.bit = digitalPinToBitMask(pins[i]);
+    portMask[p] |= c.bit;
+#else
+    c.byte = i >> 3;
+    c.bit = 1 << (i & 7);
+    c.pin = pins[i];
+    c.shown = false;
+#endif
+    pinMode(pins[i], OUTPUT);
+    digitalWrite(pins[i], LOW);
+  }
+#ifndef __AVR__
+  bytesUsed = (count + 7) / 8;
+#endif
+
+  channelCount = count;
+  began = true;
+  start();
+  return true;
+}
+
+bool ledPanel::beginShiftRegisters(uint8_t latchPin, uint8_t registers) {
+#ifdef __AVR__
+  if (began || registers == 0 || registers > chainBytes)
+    return false;
+  uint8_t port = digitalPinToPort(latchPin);
+  if (port == NOT_A_PIN)
+    return false;
+
+  channelCount = registers * 8 < LED_PANEL_CHANNELS ? registers * 8 : LED_PANEL_CHANNELS;
+  for (uint8_t i = 0; i < channelCount; i++) {
+    panelChannel &c = channels[i];
+    clearChannel(c);
+    c.byte = i >> 3;
+    c.bit = 1 << (i & 7);
+  }
+  bytesUsed = registers;
+
+  pinMode(latchPin, OUTPUT);
+  digitalWrite(latchPin, LOW);
+  latchRegister = portOutputRegister(port);
+  latchBit = digitalPinToBitMask(latchPin);
+
+  // SS must be an output for the SPI to stay master
+  pinMode(SS, OUTPUT);
+  pinMode(MOSI, OUTPUT);
+  pinMode(SCK, OUTPUT);
+  SPCR = _BV(SPE) | _BV(MSTR);  // mode 0, most significant bit first
+  SPSR = _BV(SPI2X);            // clk / 2
+
+  // every LED off before the first frame
+  shiftPlane(NULL);
+  *latchRegister |= latchBit;
+  *latchRegister &= ~latchBit;
+
+  began = true;
+  start();
+  return true;
+#else
+  (void)latchPin;
+  (void)registers;
+  return false;
+#endif
+}
+
+void ledPanel::blink(uint8_t channel, uint16_t period, uint16_t phase, uint8_t brightness,
+                     uint16_t onTime) {
+  if (channel >= channelCount)
+    return;
+  if (period < shortestPeriod)
+    period = shortestPeriod;
+  if (onTime == 0)
+    onTime = period / 2;
+
+  // where the panel's clock is in the period, worked out before holding the interrupt off and
+  // brought up to date for any frame that passed meanwhile
+  uint32_t counted = frames();
+  uint16_t position = ((counted % period) * LED_PANEL_FRAME_MS + phase % period) % period;
+
+  panelGuard guard;
+  for (; counted != frameCount; counted++)
+    position = nextPosition(position, period);
+  panelChannel &c = channels[channel];
+  c.period = period;
+  c.onTime = onTime;
+  c.position = position;
+  c.brightness = brightness;
+  c.lit = position < onTime;
+  paint(c);
+#ifndef __AVR__
+  show(c);
+#endif
+}
+
+void ledPanel::set(uint8_t channel, uint8_t brightness) {
+  if (channel >= channelCount)
+    return;
+  panelGuard guard;
+  panelChannel &c = channels[channel];
+  c.period = 0;
+  c.brightness = brightness;
+  c.lit = true;
+  paint(c);
+#ifndef __AVR__
+  show(c);
+#endif
+}
+
+bool ledPanel::isLit(uint8_t channel) {
+  if (channel >= channelCount)
+    return false;
+  panelGuard guard;
+  return channels[channel].lit && channels[channel].brightness != 0;
+}
+
+uint32_t ledPanel::frames(void) {
+  panelGuard guard;
+  return frameCount;
+}
@@ -0,0 +1,90 @@
+/*
+  ledPanel.h
+
+  A timer interrupt driven indicator panel of up to 64 LEDs. Each LED blinks with its own period,
+  phase and on time at its own brightness, and every blink is counted from one shared frame clock,
+  so LEDs with the same period stay in step for as long as the panel runs. Timing an LED from
+  loop() by setting lastMillis = millis() after each toggle adds that pass's latency to every
+  period and lets LEDs wander apart; here no LED has a clock of its own to drift.
+
+  const uint8_t pins[] = {2, 3, 4, 5, 6, 7, 8, 9};
+  ledPanel::beginPins(pins, 8);                 // LEDs on pins, or
+  ledPanel::beginShiftRegisters(10, 8);         // 64 LEDs on eight 74HC595s latched by pin 10
+
+  ledPanel::blink(0, 1000, 0, 255);             // 500 ms on, 500 ms off at full brightness
+  ledPanel::blink(1, 1000, 500, 255);           // the same half a period later
+  ledPanel::blink(2, 250, 0, 32, 50);           // a dim 50 ms flash every 250 ms
+  ledPanel::set(3, 128);                        // steady at half brightness
+
+  A blink's phase is where in its period the LED is at the start of the panel's frame clock, not
+  when blink() is called, so LEDs started at different times with the same period and phase blink
+  together. An LED is lit for the first onTime milliseconds of each period, half of it when onTime
+  is zero. Blinks change on frame boundaries, so an edge can be up to a frame late, but lateness
+  never adds up from one period to the next.
+
+  Brightness from 0 to 255 comes from bit-angle modulation: every frame shows the eight bit planes
+  of all LEDs' brightness, bit n for 2^n units of time, then a blank unit. A frame is 256 units of
+  31.25 us, 8 ms, so the panel refreshes at 125 Hz with nine interrupts a frame however many LEDs
+  it drives. Brightness is linear, a full 255 is lit 255/256 of the time.
+
+  Each interrupt writes a whole bit plane at once. LEDs on pins are sorted by port, and each port
+  register gets a single read-modify-write, so LEDs on one port change at the same instant. A
+  chain of shift registers is loaded over hardware SPI with the next plane while the current one
+  shows and latched at the start of its slot. The first register of the chain, nearest the board,
+  holds channels 0 to 7, QA to QH. SPI takes the MOSI, SCK and SS pins, so on an Uno pin 13 and
+  its LED carry the clock.
+
+  On AVR boards the interrupt comes from Timer1, which the Servo library and analogWrite() on
+  pins 9 and 10 of an Uno also use, and the clock must be 8 or 16 MHz. Timer1 counts freely and
+  each slot ends a fixed count after the last, so an interrupt served late shortens its slot
+  instead of moving the frames; only interrupts held off for a whole turn of the timer, 4 ms at
+  16 MHz, lose frame time. In the native build a nativeHal timer runs the frame clock and pins
+  show whether their LED is lit, without modulating brightness; beginShiftRegisters() needs
+  hardware SPI and returns false there. Build with -D LED_PANEL_CHANNELS=n for more than 16 LEDs.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef ledPanel_h
+#define ledPanel_h
+
+#include <Arduino.h>
+
+#ifndef LED_PANEL_CHANNELS
+#define LED_PANEL_CHANNELS 16
+#endif
+
+#if LED_PANEL_CHANNELS < 1 || LED_PANEL_CHANNELS > 64
+#error "LED_PANEL_CHANNELS must be from 1 to 64"
+#endif
+
+#define LED_PANEL_FRAME_MS 8
+
+namespace ledPanel {
+// drive one LED per pin, starting off; false when a pin has no port or the panel already began
+bool beginPins(const uint8_t pins[], uint8_t count);
+
+// drive eight LEDs per 74HC595 of a chain on the hardware SPI pins, starting off
+bool beginShiftRegisters(uint8_t latchPin, uint8_t registers);
+
+// blink period milliseconds apart, lit for onTime of them (half the period when zero)
+void blink(uint8_t channel, uint16_t period, uint16_t phase, uint8_t brightness,
+           uint16_t onTime = 0);
+
+// stop any blink and hold a brightness
+void set(uint8_t channel, uint8_t brightness);
+inline void off(uint8_t channel) { set(channel, 0); }
+
+// the LED is in the lit part of its blink, or holds a brightness
+bool isLit(uint8_t channel);
+
+// frames since the panel began, every blink is timed from this count
+uint32_t frames(void);
+}  // namespace ledPanel
+
+#endif
@@ -0,0 +1,233 @@
+#include <ledPatterns.h>
+
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#endif
+
+const uint8_t ledBlinkLevels[2] PROGMEM = {255, 0};
+
+static const uint8_t fadeInLevels[32] PROGMEM = {
+    0,  0,  1,  1,  3,  5,  7,   10,  13,  17,  21,  26,  32,  38,  44,  52,
+    60, 68, 77, 87, 97, 108, 120, 132, 145, 159, 173, 188, 204, 220, 237, 255};
+static const uint8_t fadeOutLevels[32] PROGMEM = {
+    255, 237, 220, 204, 188, 173, 159, 145, 132, 120, 108, 97, 87, 77, 68, 60,
+    52,  44,  38,  32,  26,  21,  17,  13,  10,  7,   5,   3,  1,  1,  0,  0};
+static const uint8_t breatheLevels[64] PROGMEM = {
+    0,   0,   0,   0,   0,   1,   1,   2,   4,   6,   9,   14,  19,  26,  34,  44,
+    55,  68,  82,  97,  113, 130, 147, 164, 180, 196, 210, 223, 234, 243, 250, 254,
+    255, 254, 250, 243, 234, 223, 210, 196, 180, 164, 147, 130, 113, 97,  82,  68,
+    55,  44,  34,  26,  19,  14,  9,   6,   4,   2,   1,   1,   0,   0,   0,   0};
+
+const ledPattern ledFadeIn PROGMEM = {fadeInLevels, 32, 16};
+const ledPattern ledFadeOut PROGMEM = {fadeOutLevels, 32, 16};
+const ledPattern ledBreathe PROGMEM = {breatheLevels, 64, 40};
+
+// PWM duty in ticks out of a 32 tick frame, fully on is 32 so it never switches off
+static const uint8_t pwmFrame = 32;
+static const uint8_t ticksPerMilli = LED_PATTERN_TICK_HZ / 1000;
+
+struct ledChannel {
+  const uint8_t *levels;  // NULL while holding a level
+  uint8_t steps;
+  uint8_t step;
+  uint16_t stepTime;
+  uint16_t stepLeft;  // milliseconds left of the current step
+  uint8_t repeats;    // plays left, zero for forever
+  uint8_t duty;
+  bool lit;
+#ifdef __AVR__
+  volatile uint8_t *out;
+  uint8_t bit;
+#else
+  uint8_t pin;
+#endif
+};
+
+static ledChannel channels[LED_PATTERN_CHANNELS];
+static uint8_t attached;
+static uint8_t pwmPhase;
+static uint8_t tickInMilli;
+static volatile bool running;
+
+static uint8_t dutyOf(uint8_t level) {
+  return (level + 4) >> 3;  // 0 to 32, rounded so 255 is fully on
+}
+
+static void writeLed(ledChannel &c, bool lit) {
+  if (c.lit == lit)
+    return;
+  c.lit = lit;
+#ifdef __AVR__
+  if (lit)
+    *c.out |= c.bit;
+  else
+    *c.out &= ~c.bit;
+#else
+  digitalWrite(c.pin, lit ? HIGH : LOW);
+#endif
+}
+
+static bool needsTicks(const ledChannel &c) {
+  return c.levels != NULL || (c.duty != 0 && c.duty != pwmFrame);
+}
+
+static void stopTicks(void);
+
+// one timer tick, with interrupts disabled
+static void tick(void) {
+  bool milli = ++tickInMilli == ticksPerMilli;
+  if (milli)
+    tickInMilli = 0;
+  pwmPhase = (pwmPhase + 1) & (pwmFrame - 1);
+
+  bool needed = false;
+  for (uint8_t i = 0; i < attached; i++) {
+    ledChannel &c = channels[i];
+    if (milli && c.levels != NULL && --c.stepLeft == 0) {
+      if (++c.step == c.steps) {
+        if (c.repeats == 1) {
+          c.levels = NULL;  // done, hold the last level
+          c.step--;
+        } else {
+          if (c.repeats != 0)
+            c.repeats--;
+          c.step = 0;
+        }
+      }
+      if (c.levels != NULL) {
+        c.duty = dutyOf(pgm_read_byte(c.levels + c.step));
+        c.stepLeft = c.stepTime;
+      }
+    }
+    writeLed(c, c.duty > pwmPhase);
+    needed |= needsTicks(c);
+  }
+  if (!needed)
+    stopTicks();
+}
+
+#ifdef __AVR__
+ISR(TIMER2_COMPA_vect) {
+  tick();
+}
+
+static void startTicks(void) {
+  TCCR2A = _BV(WGM21);  // clear on compare match
+#if F_CPU == 16000000L
+  TCCR2B = _BV(CS21) | _BV(CS20);  // clk / 32
+  OCR2A = F_CPU / 32 / LED_PATTERN_TICK_HZ - 1;
+#elif F_CPU == 8000000L
+  TCCR2B = _BV(CS21);  // clk / 8
+  OCR2A = F_CPU / 8 / LED_PATTERN_TICK_HZ - 1;
+#else
+#error "ledPatterns needs a 16 or 8 MHz clock for an exact tick"
+#endif
+  TCNT2 = 0;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 |= _BV(OCIE2A);
+}
+
+static void stopTicks(void) {
+  TIMSK2 &= ~_BV(OCIE2A);
+  TCCR2B = 0;
+  running = false;
+}
+#else
+static void startTicks(void) {
+  nativeHal::attachTimer(1000000UL / LED_PATTERN_TICK_HZ, tick);
+}
+
+static void stopTicks(void) {
+  nativeHal::detachTimer(tick);
+  running = false;
+}
+#endif
+
+// holds the tick off while a channel changes; native timers only fire while the clock advances
+class tickGuard {
+ public:
+#ifdef __AVR__
+  tickGuard() : oldSREG(SREG) { cli(); }
+  ~tickGuard() { SREG = oldSREG; }
+
+ private:
+  uint8_t oldSREG;
+#else
+  tickGuard() {}
+  ~tickGuard() {}
+#endif
+};
+
+// show a channel's new level right away when it is steady, and start the tick if it is needed
+static void update(ledChannel &c) {
+  if (c.duty == 0 || c.duty == pwmFrame)
+    writeLed(c, c.duty != 0);
+  if (!running && needsTicks(c)) {
+    pwmPhase = 0;
+    tickInMilli = 0;
+    running = true;
+    startTicks();
+  }
+}
+
+uint8_t ledPatterns::attach(uint8_t pin) {
+  if (attached == LED_PATTERN_CHANNELS)
+    return ledNoChannel;
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, LOW);
+
+  ledChannel &c = channels[attached];
+  c.levels = NULL;
+  c.duty = 0;
+  c.lit = false;
+#ifdef __AVR__
+  c.out = portOutputRegister(digitalPinToPort(pin));
+  c.bit = digitalPinToBitMask(pin);
+#else
+  c.pin = pin;
+#endif
+
+  tickGuard guard;
+  return attached++;  // the tick only visits a channel once it is complete
+}
+
+void ledPatterns::play(uint8_t channel, const ledPattern *pattern, uint8_t repeats) {
+  if (channel >= attached)
+    return;
+  ledPattern p;
+  memcpy_P(&p, pattern, sizeof(p));
+  if (p.steps == 0)
+    return;
+
+  tickGuard guard;
+  ledChannel &c = channels[channel];
+  c.steps = p.steps;
+  c.step = 0;
+  c.stepTime = p.stepTime ? p.stepTime : 1;
+  c.stepLeft = c.stepTime;
+  c.repeats = repeats;
+  c.duty = dutyOf(pgm_read_byte(p.levels));
+  c.levels = p.levels;
+  update(c);
+}
+
+void ledPatterns::set(uint8_t channel, uint8_t level) {
+  if (channel >= attached)
+    return;
+  tickGuard guard;
+  ledChannel &c = channels[channel];
+  c.levels = NULL;
+  c.duty = dutyOf(level);
+  update(c);
+}
+
+bool ledPatterns::isPlaying(uint8_t channel) {
+  if (channel >= attached)
+    return false;
+  tickGuard guard;
+  return channels[channel].levels != NULL;
+}
+
+bool ledPatterns::busy(void) {
+  return running;
+}
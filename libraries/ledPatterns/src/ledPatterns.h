@@ -0,0 +1,84 @@
+/*
+  ledPatterns.h
+
+  An interrupt-driven LED pattern engine. Blinking and fading an LED from loop() ties its timing to
+  however long each pass of the loop takes and costs a time check on every pass; here a timer
+  interrupt plays precomputed patterns stored in flash instead, so steps change on exact tick
+  boundaries and loop() only starts and stops patterns.
+
+  const ledPattern slowBlink PROGMEM = {ledBlinkLevels, 2, 500};  // on 500 ms, off 500 ms
+
+  uint8_t led = ledPatterns::attach(LED_BUILTIN);
+  ledPatterns::play(led, &slowBlink, 5);      // blink five times, then stay on the last level
+  ledPatterns::play(led, &ledBreathe);        // breathe until told otherwise
+  ledPatterns::set(led, 128);                 // hold half brightness
+  ledPatterns::stop(led);                     // off
+
+  A pattern is a table of brightness levels from 0 to 255 played one after another, each for the
+  pattern's step time, and repeated the given number of times or forever. When it finishes the LED
+  keeps the level of its last step. ledBlinkLevels is the on/off table most blink patterns need;
+  ledFadeIn, ledFadeOut and ledBreathe are ready-made gamma-corrected fades.
+
+  Brightness is made by software PWM in the same interrupt, 32 levels at 125 Hz on any pin. Fully
+  on and fully off are steady levels, so a pin that only blinks changes exactly once per step. The
+  interrupt runs 4000 times a second while any channel plays a pattern or holds a partial level
+  and is switched off otherwise, so idle LEDs cost nothing.
+
+  On AVR boards the tick comes from Timer2, which analogWrite() on pins 3 and 11 of an Uno also
+  uses, and the pins are written straight to their port register from the interrupt. Timer2 stops
+  in power-down sleep; busy() tells whether sleeping would freeze a pattern. In the native build
+  the tick is a nativeHal timer. Build with -D LED_PATTERN_CHANNELS=n for more than two LEDs.
+
+  created 16 Oct 2026
+  by Beaker406
+
+  MIT License
+  Copyright (c) 2022 Beaker406
+  https://github.com/Beaker406/Arduino-Sketchbook/blob/main/LICENSE
+*/
+
+#ifndef ledPatterns_h
+#define ledPatterns_h
+
+#include <Arduino.h>
+
+#ifndef LED_PATTERN_CHANNELS
+#define LED_PATTERN_CHANNELS 2
+#endif
+
+#define LED_PATTERN_TICK_HZ 4000
+
+struct ledPattern {
+  const uint8_t *levels;  // brightness of each step from 0 to 255, in flash
+  uint8_t steps;
+  uint16_t stepTime;  // milliseconds each step lasts
+};
+
+const uint8_t ledNoChannel = 0xFF;
+
+// on, then off
+extern const uint8_t ledBlinkLevels[2] PROGMEM;
+
+// half a second up or down, and a 2.5 s breath from off to on and back
+extern const ledPattern ledFadeIn PROGMEM;
+extern const ledPattern ledFadeOut PROGMEM;
+extern const ledPattern ledBreathe PROGMEM;
+
+namespace ledPatterns {
+// make a pin an output driven by the engine, starting off; returns ledNoChannel when all are used
+uint8_t attach(uint8_t pin);
+
+// play a pattern kept in flash repeats times, or until stopped when repeats is zero
+void play(uint8_t channel, const ledPattern *pattern, uint8_t repeats = 0);
+
+// stop any pattern and hold a level
+void set(uint8_t channel, uint8_t level);
+inline void stop(uint8_t channel) { set(channel, 0); }
+
+bool isPlaying(uint8_t channel);
+
+// the timer interrupt is running
+bool busy(void);
+}  // namespace ledPatterns
+
+#endif